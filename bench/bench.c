@@ -0,0 +1,312 @@
+//
+// bench.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "lexer.h"
+#include "stats.h"
+#include "utils.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif
+
+#define BENCH_MIN_SECONDS     (0.25)
+#define BENCH_NAME_MAX_LENGTH (63)
+
+typedef struct
+{
+  Slice(char) chars;
+} Buffer;
+
+typedef struct
+{
+  char   name[BENCH_NAME_MAX_LENGTH + 1];
+  size_t bytes;
+  long   tokens;
+  int    iterations;
+  double lexSeconds;
+  double compileSeconds;
+  double compilePrelexedSeconds;
+  Error  err;
+} Result;
+
+static inline size_t peak_rss(void);
+static inline void base_name(char *dest, const char *path);
+static inline void buffer_append(Buffer *buf, const char *str, Error *err);
+static inline void generate_numbers(Buffer *buf, int n, Error *err);
+static inline void generate_names(Buffer *buf, int n, Error *err);
+static inline void generate_strings(Buffer *buf, int n, Error *err);
+static inline void generate_pipeline(Buffer *buf, int n, Error *err);
+static inline long lex_all(char *source, Error *err);
+static inline void compile_once(char *source, bool prelex, Error *err);
+static void run(Result *res, char *source);
+static void run_generated(Result *res, const char *name,
+  void (*generate)(Buffer *, int, Error *), int n);
+static void print_results(FILE *fp, Result *results, int numResults);
+
+static inline size_t peak_rss(void)
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return counters.PeakWorkingSetSize;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0;
+  #ifdef __APPLE__
+    return (size_t) usage.ru_maxrss;
+  #else
+    return (size_t) usage.ru_maxrss * 1024;
+  #endif
+#endif
+}
+
+static inline void base_name(char *dest, const char *path)
+{
+  const char *start = path;
+  for (const char *c = path; *c; ++c)
+    if (*c == '/' || *c == '\\')
+      start = c + 1;
+  const char *end = strrchr(start, '.');
+  int length = end ? (int) (end - start) : (int) strlen(start);
+  if (length > BENCH_NAME_MAX_LENGTH)
+    length = BENCH_NAME_MAX_LENGTH;
+  memcpy(dest, start, length);
+  dest[length] = '\0';
+}
+
+static inline void buffer_append(Buffer *buf, const char *str, Error *err)
+{
+  // Overwrite the terminator and append a new one.
+  --buf->chars.len;
+  slice_append_n(&buf->chars, str, strlen(str) + 1, err);
+}
+
+static inline void generate_numbers(Buffer *buf, int n, Error *err)
+{
+  char str[32];
+  buffer_append(buf, "let xs = [", err);
+  for (int i = 0; i < n && ok(err); ++i)
+  {
+    switch (i % 4)
+    {
+    case 0: snprintf(str, sizeof(str), "%d, ", i); break;
+    case 1: snprintf(str, sizeof(str), "%d.%d, ", i, i % 97); break;
+    case 2: snprintf(str, sizeof(str), "%de-%d, ", i, i % 11); break;
+    case 3:
+      snprintf(str, sizeof(str), "0.%09u%09d, ", (unsigned) i * 7919u % 1000000000u, i);
+      break;
+    }
+    buffer_append(buf, str, err);
+  }
+  if (!ok(err)) return;
+  buffer_append(buf, "0]; xs", err);
+}
+
+static inline void generate_names(Buffer *buf, int n, Error *err)
+{
+  char str[48];
+  buffer_append(buf, "let value = 0;\nvalue", err);
+  for (int i = 0; i < n && ok(err); ++i)
+  {
+    snprintf(str, sizeof(str), " + some_name_%d * other_%d", i, i % 7);
+    buffer_append(buf, str, err);
+  }
+}
+
+static inline void generate_strings(Buffer *buf, int n, Error *err)
+{
+  char str[48];
+  buffer_append(buf, "\"\"", err);
+  for (int i = 0; i < n && ok(err); ++i)
+  {
+    snprintf(str, sizeof(str), "\n  ++ \"string literal number %d\"", i);
+    buffer_append(buf, str, err);
+  }
+}
+
+static inline void generate_pipeline(Buffer *buf, int n, Error *err)
+{
+  buffer_append(buf, "let inc = x => x + 1;\n0", err);
+  for (int i = 0; i < n && ok(err); ++i)
+    buffer_append(buf, " |> inc", err);
+}
+
+static inline long lex_all(char *source, Error *err)
+{
+  Lexer lex;
+  lexer_init(&lex, source, err);
+  long n = 0;
+  while (ok(err) && lex.token.kind != TOKEN_KIND_EOF)
+  {
+    ++n;
+    lexer_next(&lex);
+  }
+  return n;
+}
+
+static inline void compile_once(char *source, bool prelex, Error *err)
+{
+  Diagnostics diag;
+  diagnostics_init(&diag, err);
+  if (!ok(err)) return;
+  if (prelex)
+    compile_buffered(source, err, &diag);
+  else
+    compile(source, err, &diag);
+  diagnostics_deinit(&diag);
+}
+
+static void run(Result *res, char *source)
+{
+  error_init(&res->err);
+  res->bytes = strlen(source);
+  res->tokens = 0;
+  res->iterations = 0;
+  double start = stats_clock();
+  double elapsed = 0;
+  do
+  {
+    res->tokens = lex_all(source, &res->err);
+    if (!ok(&res->err)) return;
+    ++res->iterations;
+    elapsed = stats_clock() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+  res->lexSeconds = elapsed / res->iterations;
+  int iterations = 0;
+  start = stats_clock();
+  do
+  {
+    compile_once(source, false, &res->err);
+    if (!ok(&res->err)) return;
+    ++iterations;
+    elapsed = stats_clock() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+  res->compileSeconds = elapsed / iterations;
+  iterations = 0;
+  start = stats_clock();
+  do
+  {
+    compile_once(source, true, &res->err);
+    if (!ok(&res->err)) return;
+    ++iterations;
+    elapsed = stats_clock() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+  res->compilePrelexedSeconds = elapsed / iterations;
+}
+
+static void run_generated(Result *res, const char *name,
+  void (*generate)(Buffer *, int, Error *), int n)
+{
+  copy_cstring(res->name, name, BENCH_NAME_MAX_LENGTH);
+  error_init(&res->err);
+  Buffer buf;
+  slice_init(&buf.chars, &res->err);
+  if (!ok(&res->err)) return;
+  slice_append(&buf.chars, '\0', &res->err);
+  if (ok(&res->err))
+    generate(&buf, n, &res->err);
+  if (ok(&res->err))
+    run(res, buf.chars.slots);
+  slice_deinit(&buf.chars);
+}
+
+static void print_results(FILE *fp, Result *results, int numResults)
+{
+  fprintf(fp, "{\n  \"benchmarks\": [");
+  for (int i = 0; i < numResults; ++i)
+  {
+    Result *res = &results[i];
+    fprintf(fp, "%s\n    {\n", i ? "," : "");
+    fprintf(fp, "      \"name\": \"%s\",\n", res->name);
+    if (!ok(&res->err))
+    {
+      fprintf(fp, "      \"error\": \"");
+      for (const char *c = res->err.str; *c; ++c)
+        fprintf(fp, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+      fprintf(fp, "\"\n    }");
+      continue;
+    }
+    fprintf(fp, "      \"bytes\": %zu,\n", res->bytes);
+    fprintf(fp, "      \"tokens\": %ld,\n", res->tokens);
+    fprintf(fp, "      \"iterations\": %d,\n", res->iterations);
+    fprintf(fp, "      \"lex_seconds\": %.9g,\n", res->lexSeconds);
+    fprintf(fp, "      \"tokens_per_sec\": %.9g,\n", res->tokens / res->lexSeconds);
+    fprintf(fp, "      \"compile_seconds\": %.9g,\n", res->compileSeconds);
+    fprintf(fp, "      \"compile_bytes_per_sec\": %.9g,\n", res->bytes / res->compileSeconds);
+    fprintf(fp, "      \"compile_prelexed_seconds\": %.9g\n", res->compilePrelexedSeconds);
+    fprintf(fp, "    }");
+  }
+  fprintf(fp, "\n  ],\n  \"peak_rss_bytes\": %zu\n}\n", peak_rss());
+}
+
+int main(int argc, char *argv[])
+{
+  const char *output = NULL;
+  int first = 1;
+  if (argc >= 3 && !strcmp(argv[1], "-o"))
+  {
+    output = argv[2];
+    first = 3;
+  }
+  int numResults = argc - first + 4;
+  Result *results = calloc(numResults, sizeof(*results));
+  if (!results)
+  {
+    fprintf(stderr, "ERROR: out of memory\n");
+    return EXIT_FAILURE;
+  }
+  int n = 0;
+  for (int i = first; i < argc; ++i)
+  {
+    Result *res = &results[n++];
+    base_name(res->name, argv[i]);
+    error_init(&res->err);
+    char *source = read_file(argv[i], &res->err);
+    if (!ok(&res->err)) continue;
+    run(res, source);
+    memory_free(source);
+  }
+  run_generated(&results[n++], "gen_numbers", generate_numbers, 1000000);
+  run_generated(&results[n++], "gen_names", generate_names, 100000);
+  run_generated(&results[n++], "gen_strings", generate_strings, 100000);
+  run_generated(&results[n++], "gen_pipeline", generate_pipeline, 100000);
+  FILE *fp = stdout;
+  if (output)
+  {
+#ifdef _WIN32
+    fopen_s(&fp, output, "w");
+#else
+    fp = fopen(output, "w");
+#endif
+    if (!fp)
+    {
+      fprintf(stderr, "ERROR: cannot open file '%s'\n", output);
+      free(results);
+      return EXIT_FAILURE;
+    }
+  }
+  print_results(fp, results, numResults);
+  if (fp != stdout)
+    fclose(fp);
+  bool success = true;
+  for (int i = 0; i < numResults; ++i)
+    success = success && ok(&results[i].err);
+  free(results);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+//
+// glim.h
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef GLIM_H
+#define GLIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+  #if defined(GLIM_EXPORTS)
+    #define GLIM_API __declspec(dllexport)
+  #elif defined(GLIM_SHARED)
+    #define GLIM_API __declspec(dllimport)
+  #else
+    #define GLIM_API
+  #endif
+#elif defined(__GNUC__)
+  #define GLIM_API __attribute__((visibility("default")))
+#else
+  #define GLIM_API
+#endif
+
+#define GLIM_ERROR_MAX_LENGTH   (511)
+#define GLIM_MESSAGE_MAX_LENGTH (511)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  bool ok;
+  char str[GLIM_ERROR_MAX_LENGTH + 1];
+} GlimError;
+
+typedef enum
+{
+  GLIM_MESSAGE_KIND_NOTE,
+  GLIM_MESSAGE_KIND_WARNING,
+  GLIM_MESSAGE_KIND_ERROR
+} GlimMessageKind;
+
+typedef struct
+{
+  GlimMessageKind kind;
+  char            str[GLIM_MESSAGE_MAX_LENGTH + 1];
+} GlimMessage;
+
+typedef struct
+{
+  struct
+  {
+    size_t      cap;
+    size_t      len;
+    GlimMessage *slots;
+  } messages;
+} GlimDiagnostics;
+
+typedef struct
+{
+  char            *source;
+  GlimDiagnostics diag;
+} GlimProgram;
+
+typedef struct
+{
+  double lexSeconds;
+  double compileSeconds;
+  long   numTokens;
+  long   numNodes;
+  long   numAllocs;
+  size_t allocBytes;
+  long   numReallocs;
+  size_t reallocBytes;
+  long   numSliceGrowths;
+  size_t sliceGrowthBytes;
+} GlimStats;
+
+GLIM_API void glim_error_print(GlimError *err);
+GLIM_API void glim_diagnostics_print(GlimDiagnostics *diag);
+
+// On failure, glim_program_init releases everything it allocated; only call
+// glim_program_deinit on a program that was initialised successfully.
+GLIM_API void glim_program_init(GlimProgram *prog, const char *source, GlimError *err);
+GLIM_API void glim_program_deinit(GlimProgram *prog);
+
+GLIM_API void glim_stats_begin(GlimStats *stats);
+GLIM_API void glim_stats_end(void);
+GLIM_API void glim_stats_print(GlimStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLIM_H
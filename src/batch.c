@@ -0,0 +1,231 @@
+//
+// batch.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include "batch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "thread.h"
+#include "utils.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <dirent.h>
+  #include <sys/stat.h>
+#endif
+
+typedef struct
+{
+  Batch  *batch;
+  Mutex  mtx;
+  size_t next;
+} Queue;
+
+static inline bool has_extension(const char *path, const char *ext);
+static inline void join_path(char *dest, const char *dir, const char *name, Error *err);
+static int compare_jobs(const void *a, const void *b);
+static void compile_job(CompileJob *job);
+static void compile_worker(void *arg);
+
+static inline bool has_extension(const char *path, const char *ext)
+{
+  size_t pathLength = strlen(path);
+  size_t extLength = strlen(ext);
+  return pathLength > extLength && !strcmp(&path[pathLength - extLength], ext);
+}
+
+static inline void join_path(char *dest, const char *dir, const char *name, Error *err)
+{
+  size_t dirLength = strlen(dir);
+  while (dirLength && (dir[dirLength - 1] == '/' || dir[dirLength - 1] == '\\'))
+    --dirLength;
+  int n = snprintf(dest, BATCH_PATH_MAX_LENGTH + 1, "%.*s/%s", (int) dirLength, dir, name);
+  if (n < 0 || n > BATCH_PATH_MAX_LENGTH)
+    error_set(err, "path too long '%.*s/%s'", (int) dirLength, dir, name);
+}
+
+static int compare_jobs(const void *a, const void *b)
+{
+  const CompileJob *job1 = a;
+  const CompileJob *job2 = b;
+  return strcmp(job1->path, job2->path);
+}
+
+static void compile_job(CompileJob *job)
+{
+  char *source = read_file(job->path, &job->err);
+  if (!ok(&job->err)) return;
+  compile(source, &job->err, &job->diag);
+  memory_free(source);
+}
+
+static void compile_worker(void *arg)
+{
+  Queue *queue = arg;
+  Batch *batch = queue->batch;
+  for (;;)
+  {
+    mutex_lock(&queue->mtx);
+    size_t i = queue->next++;
+    mutex_unlock(&queue->mtx);
+    if (i >= batch->jobs.len) break;
+    compile_job(&slice_get(&batch->jobs, i));
+  }
+}
+
+void batch_init(Batch *batch, Error *err)
+{
+  slice_init(&batch->jobs, err);
+}
+
+void batch_deinit(Batch *batch)
+{
+  for (size_t i = 0; i < batch->jobs.len; ++i)
+  {
+    CompileJob *job = &slice_get(&batch->jobs, i);
+    memory_free(job->path);
+    diagnostics_deinit(&job->diag);
+  }
+  slice_deinit(&batch->jobs);
+}
+
+void batch_add_file(Batch *batch, const char *path, Error *err)
+{
+  size_t size = strlen(path) + 1;
+  CompileJob job;
+  job.path = memory_alloc(size, err);
+  if (!ok(err)) return;
+  memcpy(job.path, path, size);
+  error_init(&job.err);
+  diagnostics_init(&job.diag, err);
+  if (!ok(err)) goto fail;
+  slice_append(&batch->jobs, job, err);
+  if (!ok(err)) goto fail_diag;
+  return;
+fail_diag:
+  diagnostics_deinit(&job.diag);
+fail:
+  memory_free(job.path);
+}
+
+void batch_add_dir(Batch *batch, const char *path, Error *err)
+{
+  size_t start = batch->jobs.len;
+  char child[BATCH_PATH_MAX_LENGTH + 1];
+#ifdef _WIN32
+  char pattern[BATCH_PATH_MAX_LENGTH + 1];
+  join_path(pattern, path, "*", err);
+  if (!ok(err)) return;
+  WIN32_FIND_DATAA data;
+  HANDLE handle = FindFirstFileA(pattern, &data);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    error_set(err, "cannot open directory '%s'", path);
+    return;
+  }
+  do
+  {
+    const char *name = data.cFileName;
+    if (!strcmp(name, ".") || !strcmp(name, "..")) continue;
+    join_path(child, path, name, err);
+    if (!ok(err)) break;
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      batch_add_dir(batch, child, err);
+    else if (has_extension(name, BATCH_FILE_EXTENSION))
+      batch_add_file(batch, child, err);
+    if (!ok(err)) break;
+  } while (FindNextFileA(handle, &data));
+  FindClose(handle);
+#else
+  DIR *dir = opendir(path);
+  if (!dir)
+  {
+    error_set(err, "cannot open directory '%s'", path);
+    return;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)))
+  {
+    const char *name = entry->d_name;
+    if (!strcmp(name, ".") || !strcmp(name, "..")) continue;
+    join_path(child, path, name, err);
+    if (!ok(err)) break;
+    struct stat st;
+    if (stat(child, &st)) continue;
+    if (S_ISDIR(st.st_mode))
+      batch_add_dir(batch, child, err);
+    else if (has_extension(name, BATCH_FILE_EXTENSION))
+      batch_add_file(batch, child, err);
+    if (!ok(err)) break;
+  }
+  closedir(dir);
+#endif
+  if (!ok(err)) return;
+  // Directory order is unspecified, so sort to keep the output deterministic.
+  qsort(&batch->jobs.slots[start], batch->jobs.len - start, sizeof(CompileJob), compare_jobs);
+}
+
+void batch_compile(Batch *batch, int numThreads, Error *err)
+{
+  if (numThreads <= 0)
+    numThreads = thread_hardware_concurrency();
+  if ((size_t) numThreads > batch->jobs.len)
+    numThreads = (int) batch->jobs.len;
+  Queue queue = {
+    .batch = batch,
+    .next = 0
+  };
+  mutex_init(&queue.mtx);
+  if (numThreads <= 1)
+  {
+    compile_worker(&queue);
+    mutex_deinit(&queue.mtx);
+    return;
+  }
+  Thread *threads = memory_alloc(sizeof(*threads) * numThreads, err);
+  if (!ok(err))
+  {
+    mutex_deinit(&queue.mtx);
+    return;
+  }
+  int numStarted = 0;
+  for (; numStarted < numThreads; ++numStarted)
+  {
+    thread_start(&threads[numStarted], compile_worker, &queue, err);
+    if (!ok(err)) break;
+  }
+  for (int i = 0; i < numStarted; ++i)
+    thread_join(&threads[i]);
+  mutex_deinit(&queue.mtx);
+  memory_free(threads);
+}
+
+bool batch_ok(Batch *batch)
+{
+  for (size_t i = 0; i < batch->jobs.len; ++i)
+    if (!ok(&slice_get(&batch->jobs, i).err))
+      return false;
+  return true;
+}
+
+void batch_print(Batch *batch)
+{
+  for (size_t i = 0; i < batch->jobs.len; ++i)
+  {
+    CompileJob *job = &slice_get(&batch->jobs, i);
+    // Errors go to the same stream as diagnostics so the output stays in
+    // path order when both are captured together.
+    diagnostics_print_with_prefix(&job->diag, job->path);
+    if (!ok(&job->err))
+      printf("%s: ERROR: %s\n", job->path, job->err.str);
+  }
+}
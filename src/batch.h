@@ -0,0 +1,39 @@
+//
+// batch.h
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "diagnostics.h"
+
+#define BATCH_PATH_MAX_LENGTH (4095)
+#define BATCH_FILE_EXTENSION  ".glim"
+
+typedef struct
+{
+  char        *path;
+  Error       err;
+  Diagnostics diag;
+} CompileJob;
+
+typedef struct
+{
+  Slice(CompileJob) jobs;
+} Batch;
+
+void batch_init(Batch *batch, Error *err);
+void batch_deinit(Batch *batch);
+void batch_add_file(Batch *batch, const char *path, Error *err);
+void batch_add_dir(Batch *batch, const char *path, Error *err);
+void batch_compile(Batch *batch, int numThreads, Error *err);
+bool batch_ok(Batch *batch);
+void batch_print(Batch *batch);
+
+#endif // BATCH_H
@@ -9,16 +9,20 @@
 //
 
 #include "compiler.h"
+#include <math.h>
 #include "diagnostics.h"
 #include "lexer.h"
+#include "number.h"
+#include "stats.h"
+#include "token_buffer.h"
 
-#define current(p) ((p)->lex->token)
+#define current(p) compiler_token(p)
 
-#define match(p, t) (current(p).kind == (t))
+#define match(p, t) ((p)->kind == (t))
 
 #define next(p) \
   do { \
-    lexer_next((p)->lex); \
+    compiler_next(p); \
     if (!compiler_ok(p)) return; \
   } while (0)
 
@@ -33,15 +37,26 @@
 
 #define compiler_ok(p) ok((p)->err)
 
+#define COMPILER_MAX_DEPTH (512)
+
 typedef struct
 {
   Lexer       *lex;
+  TokenBuffer *buf;
+  size_t      index;
+  TokenKind   kind;
+  int         depth;
   Error       *err;
   Diagnostics *diag;
 } Compiler;
 
-static inline void compiler_init(Compiler *comp, Lexer *lex, Error *err, Diagnostics *diag);
+static inline void compiler_init(Compiler *comp, Lexer *lex, TokenBuffer *buf, Error *err,
+  Diagnostics *diag);
+static inline void compiler_next(Compiler *comp);
+static inline Token compiler_token(Compiler *comp);
+static inline void locate(Compiler *comp, Token *token);
 static inline void unexpected_token_error(Compiler *comp);
+static inline void too_deep_error(Compiler *comp);
 static inline void compile_stmt(Compiler *comp);
 static inline void compile_let_stmt(Compiler *comp);
 static inline void compile_expr(Compiler *comp);
@@ -59,35 +74,106 @@ static inline void compile_prim_expr(Compiler *comp);
 static inline void compile_array_expr(Compiler *comp);
 static inline void compile_name_expr(Compiler *comp);
 static inline void compile_call(Compiler *comp);
+static void compile_tokens(Lexer *lex, TokenBuffer *buf, Error *err, Diagnostics *diag);
 
-static inline void compiler_init(Compiler *comp, Lexer *lex, Error *err, Diagnostics *diag)
+static inline void compiler_init(Compiler *comp, Lexer *lex, TokenBuffer *buf, Error *err,
+  Diagnostics *diag)
 {
   comp->lex = lex;
+  comp->buf = buf;
+  comp->index = 0;
+  comp->depth = 0;
   comp->err = err;
   comp->diag = diag;
+  if (lex)
+  {
+    comp->kind = lex->token.kind;
+    return;
+  }
+  if (!token_buffer_len(buf))
+  {
+    *err = buf->err;
+    return;
+  }
+  comp->kind = token_buffer_kind(buf, 0);
+}
+
+static inline void compiler_next(Compiler *comp)
+{
+  if (comp->lex)
+  {
+    lexer_next(comp->lex);
+    comp->kind = comp->lex->token.kind;
+    return;
+  }
+  // Advancing only reads the kind; the rest of a pre-lexed token is looked up
+  // by compiler_token where the parser actually uses it.
+  TokenBuffer *buf = comp->buf;
+  if (++comp->index < token_buffer_len(buf))
+  {
+    comp->kind = token_buffer_kind(buf, comp->index);
+    return;
+  }
+  // The buffer stops short only where lexing failed.
+  *comp->err = buf->err;
+}
+
+static inline Token compiler_token(Compiler *comp)
+{
+  if (comp->lex)
+    return comp->lex->token;
+  TokenBuffer *buf = comp->buf;
+  size_t index = comp->index;
+  return (Token) {
+    .kind = comp->kind,
+    .ln = 0,
+    .col = 0,
+    .length = token_buffer_length(buf, index),
+    .chars = token_buffer_chars(buf, index)
+  };
+}
+
+static inline void locate(Compiler *comp, Token *token)
+{
+  if (comp->buf)
+    token_buffer_locate(comp->buf, comp->index, &token->ln, &token->col);
 }
 
 static inline void unexpected_token_error(Compiler *comp)
 {
-  Token *token = &comp->lex->token;
-  if (token->kind == TOKEN_KIND_EOF)
+  Token token = current(comp);
+  locate(comp, &token);
+  if (token.kind == TOKEN_KIND_EOF)
   {
-    error_set(comp->err, "unexpected end of file [%d:%d]", token->ln, token->col);
+    error_set(comp->err, "unexpected end of file [%d:%d]", token.ln, token.col);
     return;
   }
-  error_set(comp->err, "unexpected token '%.*s' [%d:%d]", token->length, token->chars,
-    token->ln, token->col);
+  error_set(comp->err, "unexpected token '%.*s' [%d:%d]", token.length, token.chars,
+    token.ln, token.col);
 }
 
+static inline void too_deep_error(Compiler *comp)
+{
+  Token token = current(comp);
+  locate(comp, &token);
+  error_set(comp->err, "expression nested too deeply [%d:%d]", token.ln, token.col);
+}
+
+// Every recursive path in the parser goes through compile_expr or
+// compile_unary_expr, which both count nesting against COMPILER_MAX_DEPTH so
+// hostile input cannot exhaust the stack. Error paths return early without
+// unwinding the depth, since compilation stops anyway.
+
 static inline void compile_stmt(Compiler *comp)
 {
-  if (match(comp, TOKEN_KIND_EOF))
-    return;
-  if (match(comp, TOKEN_KIND_LET_KW))
+  // Iterate rather than recurse, so long runs of lets use constant stack.
+  while (match(comp, TOKEN_KIND_LET_KW))
   {
     compile_let_stmt(comp);
-    return;
+    if (!compiler_ok(comp)) return;
   }
+  if (match(comp, TOKEN_KIND_EOF))
+    return;
   compile_expr(comp);
   if (!compiler_ok(comp)) return;
   if (!match(comp, TOKEN_KIND_EOF))
@@ -96,6 +182,7 @@ static inline void compile_stmt(Compiler *comp)
 
 static inline void compile_let_stmt(Compiler *comp)
 {
+  stats_count(numNodes);
   next(comp);
   if (!match(comp, TOKEN_KIND_NAME))
   {
@@ -109,19 +196,26 @@ static inline void compile_let_stmt(Compiler *comp)
   compile_expr(comp);
   if (!compiler_ok(comp)) return;
   consume(comp, TOKEN_KIND_SEMICOLON);
-  compile_stmt(comp);
 }
 
 static inline void compile_expr(Compiler *comp)
 {
+  if (comp->depth == COMPILER_MAX_DEPTH)
+  {
+    too_deep_error(comp);
+    return;
+  }
+  ++comp->depth;
   compile_ternary_expr(comp);
   if (!compiler_ok(comp)) return;
   while (match(comp, TOKEN_KIND_PIPEGT))
   {
+    stats_count(numNodes);
     next(comp);
     compile_ternary_expr(comp);
     if (!compiler_ok(comp)) return;
   }
+  --comp->depth;
 }
 
 static inline void compile_ternary_expr(Compiler *comp)
@@ -130,6 +224,7 @@ static inline void compile_ternary_expr(Compiler *comp)
   if (!compiler_ok(comp)) return;
   if (!match(comp, TOKEN_KIND_QMARK))
     return;
+  stats_count(numNodes);
   next(comp);
   compile_expr(comp);
   if (!compiler_ok(comp)) return;
@@ -143,6 +238,7 @@ static inline void compile_or_expr(Compiler *comp)
   if (!compiler_ok(comp)) return;
   while (match(comp, TOKEN_KIND_PIPEPIPE))
   {
+    stats_count(numNodes);
     next(comp);
     compile_and_expr(comp);
     if (!compiler_ok(comp)) return;
@@ -155,6 +251,7 @@ static inline void compile_and_expr(Compiler *comp)
   if (!compiler_ok(comp)) return;
   while (match(comp, TOKEN_KIND_AMPAMP))
   {
+    stats_count(numNodes);
     next(comp);
     compile_eq_expr(comp);
     if (!compiler_ok(comp)) return;
@@ -169,6 +266,7 @@ static inline void compile_eq_expr(Compiler *comp)
   {
     if (match(comp, TOKEN_KIND_EQEQ))
     {
+      stats_count(numNodes);
       next(comp);
       compile_rel_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -176,6 +274,7 @@ static inline void compile_eq_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_BANGEQ))
     {
+      stats_count(numNodes);
       next(comp);
       compile_rel_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -193,6 +292,7 @@ static inline void compile_rel_expr(Compiler *comp)
   {
     if (match(comp, TOKEN_KIND_LT))
     {
+      stats_count(numNodes);
       next(comp);
       compile_concat_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -200,6 +300,7 @@ static inline void compile_rel_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_LTEQ))
     {
+      stats_count(numNodes);
       next(comp);
       compile_concat_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -207,6 +308,7 @@ static inline void compile_rel_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_GT))
     {
+      stats_count(numNodes);
       next(comp);
       compile_concat_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -214,6 +316,7 @@ static inline void compile_rel_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_GTEQ))
     {
+      stats_count(numNodes);
       next(comp);
       compile_concat_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -229,6 +332,7 @@ static inline void compile_concat_expr(Compiler *comp)
   if (!compiler_ok(comp)) return;
   while (match(comp, TOKEN_KIND_PLUSPLUS))
   {
+    stats_count(numNodes);
     next(comp);
     compile_add_expr(comp);
     if (!compiler_ok(comp)) return;
@@ -243,6 +347,7 @@ static inline void compile_add_expr(Compiler *comp)
   {
     if (match(comp, TOKEN_KIND_PLUS))
     {
+      stats_count(numNodes);
       next(comp);
       compile_mul_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -250,6 +355,7 @@ static inline void compile_add_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_MINUS))
     {
+      stats_count(numNodes);
       next(comp);
       compile_mul_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -267,6 +373,7 @@ static inline void compile_mul_expr(Compiler *comp)
   {
     if (match(comp, TOKEN_KIND_STAR))
     {
+      stats_count(numNodes);
       next(comp);
       compile_unary_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -274,6 +381,7 @@ static inline void compile_mul_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_SLASH))
     {
+      stats_count(numNodes);
       next(comp);
       compile_unary_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -281,6 +389,7 @@ static inline void compile_mul_expr(Compiler *comp)
     }
     if (match(comp, TOKEN_KIND_PERCENT))
     {
+      stats_count(numNodes);
       next(comp);
       compile_unary_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -292,19 +401,27 @@ static inline void compile_mul_expr(Compiler *comp)
 
 static inline void compile_unary_expr(Compiler *comp)
 {
+  if (comp->depth == COMPILER_MAX_DEPTH)
+  {
+    too_deep_error(comp);
+    return;
+  }
+  ++comp->depth;
   if (match(comp, TOKEN_KIND_BANG))
   {
+    stats_count(numNodes);
     next(comp);
     compile_unary_expr(comp);
-    return;
   }
-  if (match(comp, TOKEN_KIND_MINUS))
+  else if (match(comp, TOKEN_KIND_MINUS))
   {
+    stats_count(numNodes);
     next(comp);
     compile_unary_expr(comp);
-    return;
   }
-  compile_subscr_expr(comp);
+  else
+    compile_subscr_expr(comp);
+  --comp->depth;
 }
 
 static inline void compile_subscr_expr(Compiler *comp)
@@ -315,6 +432,7 @@ static inline void compile_subscr_expr(Compiler *comp)
   {
     if (match(comp, TOKEN_KIND_LBRACKET))
     {
+      stats_count(numNodes);
       next(comp);
       compile_expr(comp);
       if (!compiler_ok(comp)) return;
@@ -335,28 +453,41 @@ static inline void compile_prim_expr(Compiler *comp)
 {
   if (match(comp, TOKEN_KIND_NIL_KW))
   {
+    stats_count(numNodes);
     next(comp);
     return;
   }
   if (match(comp, TOKEN_KIND_FALSE_KW))
   {
+    stats_count(numNodes);
     next(comp);
     return;
   }
   if (match(comp, TOKEN_KIND_TRUE_KW))
   {
+    stats_count(numNodes);
     next(comp);
     return;
   }
   if (match(comp, TOKEN_KIND_NUMBER))
   {
+    stats_count(numNodes);
     Token num = current(comp);
+    double value = number_from_chars(num.chars, num.length);
+    if (isinf(value))
+    {
+      locate(comp, &num);
+      diagnostics_append(comp->diag, comp->err, MESSAGE_KIND_WARNING,
+        "number literal '%.*s' is out of range [%d:%d]", num.length, num.chars,
+        num.ln, num.col);
+      if (!compiler_ok(comp)) return;
+    }
     next(comp);
-    (void) num;
     return;
   }
   if (match(comp, TOKEN_KIND_STRING))
   {
+    stats_count(numNodes);
     Token str = current(comp);
     next(comp);
     (void) str;
@@ -364,6 +495,7 @@ static inline void compile_prim_expr(Compiler *comp)
   }
   if (match(comp, TOKEN_KIND_LBRACKET))
   {
+    stats_count(numNodes);
     compile_array_expr(comp);
     return;
   }
@@ -404,6 +536,7 @@ static inline void compile_array_expr(Compiler *comp)
 
 static inline void compile_name_expr(Compiler *comp)
 {
+  stats_count(numNodes);
   Token name = current(comp);
   next(comp);
   (void) name;
@@ -444,6 +577,7 @@ static inline void compile_name_expr(Compiler *comp)
 
 static inline void compile_call(Compiler *comp)
 {
+  stats_count(numNodes);
   next(comp);
   if (match(comp, TOKEN_KIND_RPAREN))
   {
@@ -461,14 +595,48 @@ static inline void compile_call(Compiler *comp)
   consume(comp, TOKEN_KIND_RPAREN);
 }
 
+static void compile_tokens(Lexer *lex, TokenBuffer *buf, Error *err, Diagnostics *diag)
+{
+  Compiler comp;
+  compiler_init(&comp, lex, buf, err, diag);
+  if (!ok(err)) return;
+  // Timed as a whole; unless the input was pre-lexed, this includes lexing.
+  Stats *stats = stats_active;
+  double start = stats ? stats_clock() : 0;
+  compile_stmt(&comp);
+  if (stats)
+    stats->compileSeconds += stats_clock() - start;
+  if (!ok(err)) return;
+  diagnostics_append(comp.diag, comp.err, MESSAGE_KIND_NOTE, "syntax is ok");
+}
+
 void compile(char *source, Error *err, Diagnostics *diag)
 {
   Lexer lex;
   lexer_init(&lex, source, err);
   if (!ok(err)) return;
-  Compiler comp;
-  compiler_init(&comp, &lex, err, diag);
-  compile_stmt(&comp);
+  compile_tokens(&lex, NULL, err, diag);
+}
+
+void compile_stream(FILE *fp, Error *err, Diagnostics *diag)
+{
+  LexerStream stream;
+  Lexer lex;
+  lexer_init_with_stream(&lex, &stream, fp, err);
+  if (ok(err))
+    compile_tokens(&lex, NULL, err, diag);
+  lexer_deinit(&lex);
+}
+
+void compile_buffered(char *source, Error *err, Diagnostics *diag)
+{
+  TokenBuffer buf;
+  Stats *stats = stats_active;
+  double start = stats ? stats_clock() : 0;
+  token_buffer_init(&buf, source, err);
+  if (stats)
+    stats->lexSeconds += stats_clock() - start;
   if (!ok(err)) return;
-  diagnostics_append(comp.diag, comp.err, MESSAGE_KIND_NOTE, "syntax is ok");
+  compile_tokens(NULL, &buf, err, diag);
+  token_buffer_deinit(&buf);
 }
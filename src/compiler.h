@@ -11,8 +11,11 @@
 #ifndef COMPILER_H
 #define COMPILER_H
 
+#include <stdio.h>
 #include "diagnostics.h"
 
 void compile(char *source, Error *err, Diagnostics *diag);
+void compile_stream(FILE *fp, Error *err, Diagnostics *diag);
+void compile_buffered(char *source, Error *err, Diagnostics *diag);
 
 #endif // COMPILER_H
@@ -59,7 +59,7 @@ void diagnostics_append_with_args(Diagnostics *diag, Error *err, MessageKind kin
   slice_append(&diag->messages, msg, err);
 }
 
-void diagnostics_print(Diagnostics *diag)
+void glim_diagnostics_print(Diagnostics *diag)
 {
   for (size_t i = 0; i < diag->messages.len; ++i)
   {
@@ -68,3 +68,13 @@ void diagnostics_print(Diagnostics *diag)
     printf("%s: %s\n", kindName, msg->str);
   }
 }
+
+void diagnostics_print_with_prefix(Diagnostics *diag, const char *prefix)
+{
+  for (size_t i = 0; i < diag->messages.len; ++i)
+  {
+    Message *msg = &slice_get(&diag->messages, i);
+    const char *kindName = message_kind_name(msg->kind);
+    printf("%s: %s: %s\n", prefix, kindName, msg->str);
+  }
+}
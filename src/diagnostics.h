@@ -11,33 +11,24 @@
 #ifndef DIAGNOSTICS_H
 #define DIAGNOSTICS_H
 
+#include "glim.h"
 #include "slice.h"
 
-#define MESSAGE_MAX_LENGTH (511)
+#define MESSAGE_MAX_LENGTH GLIM_MESSAGE_MAX_LENGTH
 
-typedef enum
-{
-  MESSAGE_KIND_NOTE,
-  MESSAGE_KIND_WARNING,
-  MESSAGE_KIND_ERROR
-} MessageKind;
+#define MESSAGE_KIND_NOTE    GLIM_MESSAGE_KIND_NOTE
+#define MESSAGE_KIND_WARNING GLIM_MESSAGE_KIND_WARNING
+#define MESSAGE_KIND_ERROR   GLIM_MESSAGE_KIND_ERROR
 
-typedef struct
-{
-  MessageKind kind;
-  char        str[MESSAGE_MAX_LENGTH + 1];
-} Message;
-
-typedef struct
-{
-  Slice(Message) messages;
-} Diagnostics;
+typedef GlimMessageKind MessageKind;
+typedef GlimMessage     Message;
+typedef GlimDiagnostics Diagnostics;
 
 void diagnostics_init(Diagnostics *diag, Error *err);
 void diagnostics_deinit(Diagnostics *diag);
 void diagnostics_append(Diagnostics *diag, Error *err, MessageKind kind, const char *fmt, ...);
 void diagnostics_append_with_args(Diagnostics *diag, Error *err, MessageKind kind,
   const char *fmt, va_list args);
-void diagnostics_print(Diagnostics *diag);
+void diagnostics_print_with_prefix(Diagnostics *diag, const char *prefix);
 
 #endif // DIAGNOSTICS_H
@@ -26,7 +26,7 @@ void error_set_with_args(Error *err, const char *fmt, va_list args)
   err->str[ERROR_MAX_LENGTH] = '\0';
 }
 
-void error_print(Error *err)
+void glim_error_print(Error *err)
 {
   if (ok(err)) return;
   fprintf(stderr, "ERROR: %s\n", err->str);
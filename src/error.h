@@ -12,9 +12,9 @@
 #define ERROR_H
 
 #include <stdarg.h>
-#include <stdbool.h>
+#include "glim.h"
 
-#define ERROR_MAX_LENGTH (511)
+#define ERROR_MAX_LENGTH GLIM_ERROR_MAX_LENGTH
 
 #define error_init(err) \
   do { \
@@ -23,14 +23,9 @@
 
 #define ok(err) ((err)->ok)
 
-typedef struct
-{
-  bool ok;
-  char str[ERROR_MAX_LENGTH + 1];
-} Error;
+typedef GlimError Error;
 
 void error_set(Error *err, const char *fmt, ...);
 void error_set_with_args(Error *err, const char *fmt, va_list args);
-void error_print(Error *err);
 
 #endif // ERROR_H
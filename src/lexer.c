@@ -11,10 +11,13 @@
 #include "lexer.h"
 #include <ctype.h>
 #include <string.h>
+#include "memory.h"
+#include "stats.h"
 
-#define char_at(l, i) ((l)->curr[(i)])
+#define char_at(l, i) ((i) < (l)->end - (l)->curr ? (l)->curr[(i)] : fill(l, i))
 #define current(l)    char_at(l, 0)
 
+static char fill(Lexer *lex, int i);
 static inline void skip_space(Lexer *lex);
 static inline void next_char(Lexer *lex);
 static inline void next_chars(Lexer *lex, int length);
@@ -26,6 +29,45 @@ static inline bool match_string(Lexer *lex, Error *err);
 static inline bool match_name(Lexer *lex);
 static inline Token token(Lexer *lex, TokenKind kind, int length, char *chars);
 
+static char fill(Lexer *lex, int i)
+{
+  LexerStream *stream = lex->stream;
+  if (!stream) return '\0';
+  while (i >= lex->end - lex->curr)
+  {
+    if (stream->eof) return '\0';
+    size_t length = lex->end - lex->curr;
+    if (length == stream->cap)
+    {
+      // A single token fills the window, which therefore starts at curr.
+      size_t cap = stream->cap << 1;
+      char *chars = memory_realloc(stream->chars, cap + 1, lex->err);
+      if (!lexer_ok(lex))
+      {
+        stream->eof = true;
+        return '\0';
+      }
+      stream->cap = cap;
+      stream->chars = chars;
+      lex->source = chars;
+      lex->curr = chars;
+      lex->end = &chars[length];
+    }
+    // Slide the unconsumed input to the front and read behind it.
+    memmove(stream->chars, lex->curr, length);
+    lex->curr = stream->chars;
+    lex->end = &stream->chars[length];
+    size_t n = fread(lex->end, 1, stream->cap - length, stream->fp);
+    lex->end += n;
+    *lex->end = '\0';
+    if (n) continue;
+    stream->eof = true;
+    if (ferror(stream->fp))
+      error_set(lex->err, "cannot read input [%d:%d]", lex->ln, lex->col);
+  }
+  return lex->curr[i];
+}
+
 static inline void skip_space(Lexer *lex)
 {
   while (isspace(current(lex)))
@@ -63,8 +105,9 @@ static inline bool match_char(Lexer *lex, char c, TokenKind kind)
 static inline bool match_chars(Lexer *lex, const char *chars, TokenKind kind)
 {
   int length = (int) strlen(chars);
-  if (memcmp(lex->curr, chars, length))
-    return false;
+  for (int i = 0; i < length; ++i)
+    if (char_at(lex, i) != chars[i])
+      return false;
   lex->token = token(lex, kind, length, lex->curr);
   next_chars(lex, length);
   return true;
@@ -73,9 +116,10 @@ static inline bool match_chars(Lexer *lex, const char *chars, TokenKind kind)
 static inline bool match_keyword(Lexer *lex, const char *kw, TokenKind kind)
 {
   int length = (int) strlen(kw);
-  if (strncmp(lex->curr, kw, length)
-   || (isalnum(char_at(lex, length)))
-   || (char_at(lex, length) == '_'))
+  for (int i = 0; i < length; ++i)
+    if (char_at(lex, i) != kw[i])
+      return false;
+  if (isalnum(char_at(lex, length)) || char_at(lex, length) == '_')
     return false;
   lex->token = token(lex, kind, length, lex->curr);
   next_chars(lex, length);
@@ -135,7 +179,8 @@ static inline bool match_string(Lexer *lex, Error *err)
     }
     if (char_at(lex, n) == '\0')
     {
-      error_set(err, "unterminated string [%d:%d]", lex->ln, lex->col);
+      if (ok(err))
+        error_set(err, "unterminated string [%d:%d]", lex->ln, lex->col);
       return false;
     }
     ++n;
@@ -172,14 +217,42 @@ void lexer_init(Lexer *lex, char *source, Error *err)
 {
   lex->source = source;
   lex->curr = source;
+  lex->end = &source[strlen(source)];
+  lex->stream = NULL;
   lex->ln = 1;
   lex->col = 1;
   lex->err = err;
   lexer_next(lex);
 }
 
+void lexer_init_with_stream(Lexer *lex, LexerStream *stream, FILE *fp, Error *err)
+{
+  stream->fp = fp;
+  stream->eof = false;
+  stream->cap = LEXER_CHUNK_SIZE;
+  stream->chars = memory_alloc(LEXER_CHUNK_SIZE + 1, err);
+  lex->stream = NULL;
+  if (!ok(err)) return;
+  stream->chars[0] = '\0';
+  lex->source = stream->chars;
+  lex->curr = stream->chars;
+  lex->end = stream->chars;
+  lex->stream = stream;
+  lex->ln = 1;
+  lex->col = 1;
+  lex->err = err;
+  lexer_next(lex);
+}
+
+void lexer_deinit(Lexer *lex)
+{
+  if (!lex->stream) return;
+  memory_free(lex->stream->chars);
+}
+
 void lexer_next(Lexer *lex)
 {
+  stats_count(numTokens);
   skip_space(lex);
   if (match_char(lex, 0, TOKEN_KIND_EOF)) return;
   if (match_char(lex, ',', TOKEN_KIND_COMMA)) return;
@@ -214,7 +287,7 @@ void lexer_next(Lexer *lex)
   if (match_keyword(lex, "let", TOKEN_KIND_LET_KW)) return;
   if (match_keyword(lex, "nil", TOKEN_KIND_NIL_KW)) return;
   if (match_keyword(lex, "true", TOKEN_KIND_TRUE_KW)) return;
-  if (match_name(lex)) return;
+  if (match_name(lex) || !lexer_ok(lex)) return;
   char c = current(lex);
   c = isprint(c) ? c : '?';
   const char *fmt = "unexpected character '%c' [%d:%d]";
@@ -11,8 +11,11 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <stdio.h>
 #include "error.h"
 
+#define LEXER_CHUNK_SIZE (16384)
+
 #define lexer_ok(l) ok((l)->err)
 
 typedef enum
@@ -37,17 +40,34 @@ typedef struct
   char      *chars;
 } Token;
 
+// Window over a stream. Consumed input is dropped whenever the window is
+// refilled, so in streaming mode token chars are only valid until the next
+// call to lexer_next. The window starts at LEXER_CHUNK_SIZE and doubles
+// whenever a single token fills it, so memory is bounded by the longest
+// token rather than by the input.
+typedef struct
+{
+  FILE   *fp;
+  bool   eof;
+  size_t cap;
+  char   *chars;
+} LexerStream;
+
 typedef struct
 {
-  char  *source;
-  char  *curr;
-  int   ln;
-  int   col;
-  Error *err;
-  Token token;
+  char        *source;
+  char        *curr;
+  char        *end;
+  LexerStream *stream;
+  int         ln;
+  int         col;
+  Error       *err;
+  Token       token;
 } Lexer;
 
 void lexer_init(Lexer *lex, char *source, Error *err);
+void lexer_init_with_stream(Lexer *lex, LexerStream *stream, FILE *fp, Error *err);
+void lexer_deinit(Lexer *lex);
 void lexer_next(Lexer *lex);
 
 #endif // LEXER_H
@@ -8,23 +8,137 @@
 // located in the root directory of this project.
 //
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "batch.h"
 #include "compiler.h"
+#include "stats.h"
+#include "utils.h"
 
-int main(void)
+static int usage(void);
+static int compile_all(const char *path);
+static int compile_stdin(bool showStats);
+static int compile_one(const char *path, bool showStats);
+
+static int usage(void)
+{
+  fprintf(stderr, "usage: glim [--stats] [<file> | -]\n"
+                  "       glim --compile-all <dir>\n");
+  return EXIT_FAILURE;
+}
+
+static int compile_all(const char *path)
+{
+  Error err;
+  error_init(&err);
+  Batch batch;
+  batch_init(&batch, &err);
+  if (!ok(&err)) goto error;
+  batch_add_dir(&batch, path, &err);
+  if (!ok(&err)) goto error_batch;
+  batch_compile(&batch, 0, &err);
+  if (!ok(&err)) goto error_batch;
+  batch_print(&batch);
+  bool success = batch_ok(&batch);
+  batch_deinit(&batch);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+error_batch:
+  batch_deinit(&batch);
+error:
+  glim_error_print(&err);
+  return EXIT_FAILURE;
+}
+
+static int compile_stdin(bool showStats)
+{
+  Error err;
+  error_init(&err);
+  Diagnostics diag;
+  diagnostics_init(&diag, &err);
+  if (!ok(&err)) goto error;
+  Stats stats;
+  if (showStats)
+    glim_stats_begin(&stats);
+  compile_stream(stdin, &err, &diag);
+  glim_stats_end();
+  if (!ok(&err)) goto error_diag;
+  glim_diagnostics_print(&diag);
+  diagnostics_deinit(&diag);
+  if (showStats)
+    glim_stats_print(&stats);
+  return EXIT_SUCCESS;
+error_diag:
+  diagnostics_deinit(&diag);
+error:
+  glim_error_print(&err);
+  return EXIT_FAILURE;
+}
+
+static int compile_one(const char *path, bool showStats)
 {
   char *source = "let fib = n => n <= 1 ? n : fib(n - 1) + fib(n - 2);\n"
                  "fib(10)";
   Error err;
   error_init(&err);
+  if (path)
+  {
+    source = read_file(path, &err);
+    if (!ok(&err)) goto error;
+  }
   Diagnostics diag;
   diagnostics_init(&diag, &err);
-  if (!ok(&err)) goto error;
+  if (!ok(&err)) goto error_source;
+  Stats stats;
+  if (showStats)
+    glim_stats_begin(&stats);
   compile(source, &err, &diag);
-  if (!ok(&err)) goto error;
-  diagnostics_print(&diag);
+  glim_stats_end();
+  if (!ok(&err)) goto error_diag;
+  glim_diagnostics_print(&diag);
+  diagnostics_deinit(&diag);
+  if (path)
+    memory_free(source);
+  if (showStats)
+    glim_stats_print(&stats);
   return EXIT_SUCCESS;
+error_diag:
+  diagnostics_deinit(&diag);
+error_source:
+  if (path)
+    memory_free(source);
 error:
-  error_print(&err);
+  glim_error_print(&err);
   return EXIT_FAILURE;
 }
+
+int main(int argc, char *argv[])
+{
+  bool showStats = false;
+  const char *compileAll = NULL;
+  const char *path = NULL;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "--stats"))
+    {
+      showStats = true;
+      continue;
+    }
+    if (!strcmp(argv[i], "--compile-all") && i + 1 < argc)
+    {
+      compileAll = argv[++i];
+      continue;
+    }
+    if (!strncmp(argv[i], "--", 2) || path)
+      return usage();
+    path = argv[i];
+  }
+  // --compile-all reports per-file diagnostics only.
+  if (compileAll && (path || showStats))
+    return usage();
+  if (compileAll)
+    return compile_all(compileAll);
+  if (path && !strcmp(path, "-"))
+    return compile_stdin(showStats);
+  return compile_one(path, showStats);
+}
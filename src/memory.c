@@ -10,11 +10,18 @@
 
 #include "memory.h"
 #include <stdlib.h>
+#include "stats.h"
 
 void *memory_alloc(size_t size, Error *err)
 {
   void *ptr = malloc(size);
   if (!ptr) error_set(err, "out of memory");
+  Stats *stats = stats_active;
+  if (stats)
+  {
+    ++stats->numAllocs;
+    stats->allocBytes += size;
+  }
   return ptr;
 }
 
@@ -22,6 +29,12 @@ void *memory_realloc(void *ptr, size_t size, Error *err)
 {
   void *_ptr = realloc(ptr, size);
   if (!_ptr) error_set(err, "out of memory");
+  Stats *stats = stats_active;
+  if (stats)
+  {
+    ++stats->numReallocs;
+    stats->reallocBytes += size;
+  }
   return _ptr;
 }
 
@@ -0,0 +1,508 @@
+//
+// number.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include "number.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "number_table.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+  #include <intrin.h>
+#endif
+
+#define MANTISSA_MAX_DIGITS (19)
+#define EXPONENT_MAX        (10000)
+#define DECIMAL_MAX_DIGITS  (800)
+#define DECIMAL_MAX_SHIFT   (60)
+
+#define DOUBLE_MANTISSA_BITS (52)
+#define DOUBLE_EXPONENT_BIAS (1023)
+
+#define is_digit(c) ((c) >= '0' && (c) <= '9')
+
+typedef struct
+{
+  uint64_t mantissa;
+  int      exp10;
+  bool     trunc;
+} Decomposed;
+
+typedef struct
+{
+  char d[DECIMAL_MAX_DIGITS];
+  int  nd;
+  int  dp;
+  bool trunc;
+} Decimal;
+
+static const double exact_pow10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int decimal_pow2[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+
+static inline double from_bits(uint64_t bits);
+static inline int leading_zeros(uint64_t x);
+static inline uint64_t mul_64(uint64_t a, uint64_t b, uint64_t *lo);
+static inline bool parse_integer(const char *chars, int length, double *result);
+static inline Decomposed decompose(const char *chars, int length);
+static inline bool clinger(Decomposed *dec, double *result);
+static inline bool eisel_lemire(uint64_t mantissa, int exp10, double *result);
+static inline void decimal_init(Decimal *dec, const char *chars, int length);
+static inline void decimal_trim(Decimal *dec);
+static inline void decimal_left_shift(Decimal *dec, int k);
+static inline void decimal_right_shift(Decimal *dec, int k);
+static inline void decimal_shift(Decimal *dec, int k);
+static inline bool decimal_should_round_up(Decimal *dec, int nd);
+static inline uint64_t decimal_rounded_integer(Decimal *dec);
+static double decimal_to_double(Decimal *dec);
+
+static inline double from_bits(uint64_t bits)
+{
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+static inline int leading_zeros(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x & 0x8000000000000000ULL))
+  {
+    x <<= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+static inline uint64_t mul_64(uint64_t a, uint64_t b, uint64_t *lo)
+{
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 uint128_t;
+  uint128_t r = (uint128_t) a * b;
+  *lo = (uint64_t) r;
+  return (uint64_t) (r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  uint64_t hi;
+  *lo = _umul128(a, b, &hi);
+  return hi;
+#else
+  uint64_t aLo = (uint32_t) a, aHi = a >> 32;
+  uint64_t bLo = (uint32_t) b, bHi = b >> 32;
+  uint64_t ll = aLo * bLo;
+  uint64_t lh = aLo * bHi;
+  uint64_t hl = aHi * bLo;
+  uint64_t hh = aHi * bHi;
+  uint64_t mid = (ll >> 32) + (uint32_t) lh + (uint32_t) hl;
+  *lo = (mid << 32) | (uint32_t) ll;
+  return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+static inline bool parse_integer(const char *chars, int length, double *result)
+{
+  // Integers of up to 15 digits are exact in a double.
+  if (length > 15) return false;
+  uint64_t n = 0;
+  for (int i = 0; i < length; ++i)
+  {
+    char c = chars[i];
+    if (!is_digit(c)) return false;
+    n = n * 10 + (uint64_t) (c - '0');
+  }
+  *result = (double) n;
+  return true;
+}
+
+static inline Decomposed decompose(const char *chars, int length)
+{
+  Decomposed dec = { .mantissa = 0, .exp10 = 0, .trunc = false };
+  int nd = 0;
+  int ndMantissa = 0;
+  int dp = 0;
+  bool sawDot = false;
+  int i = 0;
+  for (; i < length; ++i)
+  {
+    char c = chars[i];
+    if (c == '.')
+    {
+      sawDot = true;
+      dp = nd;
+      continue;
+    }
+    if (!is_digit(c)) break;
+    if (c == '0' && !nd)
+    {
+      // Leading zeros only move the decimal point.
+      --dp;
+      continue;
+    }
+    ++nd;
+    if (ndMantissa < MANTISSA_MAX_DIGITS)
+    {
+      dec.mantissa = dec.mantissa * 10 + (uint64_t) (c - '0');
+      ++ndMantissa;
+    }
+    else if (c != '0')
+      dec.trunc = true;
+  }
+  if (!sawDot)
+    dp = nd;
+  if (i < length)
+  {
+    ++i;
+    int sign = 1;
+    if (chars[i] == '+')
+      ++i;
+    else if (chars[i] == '-')
+    {
+      sign = -1;
+      ++i;
+    }
+    int exp = 0;
+    for (; i < length; ++i)
+      if (exp < EXPONENT_MAX)
+        exp = exp * 10 + (chars[i] - '0');
+    dp += exp * sign;
+  }
+  if (dec.mantissa)
+    dec.exp10 = dp - ndMantissa;
+  return dec;
+}
+
+static inline bool clinger(Decomposed *dec, double *result)
+{
+  // Both the mantissa and the power of ten are exact doubles here, so a
+  // single correctly rounded operation gives the correctly rounded result.
+  if (dec->trunc || dec->mantissa >> DOUBLE_MANTISSA_BITS) return false;
+  double f = (double) dec->mantissa;
+  int exp10 = dec->exp10;
+  if (!exp10)
+  {
+    *result = f;
+    return true;
+  }
+  if (exp10 > 0 && exp10 <= 15 + 22)
+  {
+    if (exp10 > 22)
+    {
+      f *= exact_pow10[exp10 - 22];
+      exp10 = 22;
+    }
+    if (f > 1e15) return false;
+    *result = f * exact_pow10[exp10];
+    return true;
+  }
+  if (exp10 < 0 && exp10 >= -22)
+  {
+    *result = f / exact_pow10[-exp10];
+    return true;
+  }
+  return false;
+}
+
+static inline bool eisel_lemire(uint64_t mantissa, int exp10, double *result)
+{
+  if (!mantissa)
+  {
+    *result = 0;
+    return true;
+  }
+  if (exp10 < POW10_MIN_EXP10 || exp10 > POW10_MAX_EXP10) return false;
+  // Normalize the mantissa and estimate the binary exponent.
+  int clz = leading_zeros(mantissa);
+  mantissa <<= clz;
+  uint64_t exp2 = (uint64_t) (((217706 * exp10) >> 16) + 64 + DOUBLE_EXPONENT_BIAS)
+    - (uint64_t) clz;
+  const uint64_t *pow10 = pow10_table[exp10 - POW10_MIN_EXP10];
+  uint64_t lo;
+  uint64_t hi = mul_64(mantissa, pow10[1], &lo);
+  // Widen the approximation when the low bits leave the result ambiguous.
+  if ((hi & 0x1FF) == 0x1FF && lo + mantissa < mantissa)
+  {
+    uint64_t yLo;
+    uint64_t yHi = mul_64(mantissa, pow10[0], &yLo);
+    uint64_t mergedHi = hi;
+    uint64_t mergedLo = lo + yHi;
+    if (mergedLo < lo)
+      ++mergedHi;
+    if ((mergedHi & 0x1FF) == 0x1FF && mergedLo + 1 == 0 && yLo + mantissa < mantissa)
+      return false;
+    hi = mergedHi;
+    lo = mergedLo;
+  }
+  // Shift to 54 bits, leaving one extra bit for rounding.
+  uint64_t msb = hi >> 63;
+  uint64_t bits = hi >> (msb + 9);
+  exp2 -= 1 ^ msb;
+  // Exactly halfway between two doubles; needs the exact digits.
+  if (!lo && !(hi & 0x1FF) && (bits & 3) == 1) return false;
+  bits += bits & 1;
+  bits >>= 1;
+  if (bits >> 53)
+  {
+    bits >>= 1;
+    ++exp2;
+  }
+  // Subnormals and infinities are left to the slow path.
+  if (exp2 - 1 >= 0x7FF - 1) return false;
+  bits = (exp2 << DOUBLE_MANTISSA_BITS) | (bits & 0x000FFFFFFFFFFFFFULL);
+  *result = from_bits(bits);
+  return true;
+}
+
+static inline void decimal_init(Decimal *dec, const char *chars, int length)
+{
+  dec->nd = 0;
+  dec->dp = 0;
+  dec->trunc = false;
+  // Count every significant digit, not just the stored ones, so the decimal
+  // point stays in place when digits past DECIMAL_MAX_DIGITS are dropped.
+  int nd = 0;
+  bool sawDot = false;
+  int i = 0;
+  for (; i < length; ++i)
+  {
+    char c = chars[i];
+    if (c == '.')
+    {
+      sawDot = true;
+      dec->dp = nd;
+      continue;
+    }
+    if (!is_digit(c)) break;
+    if (c == '0' && !nd)
+    {
+      --dec->dp;
+      continue;
+    }
+    ++nd;
+    if (dec->nd < DECIMAL_MAX_DIGITS)
+      dec->d[dec->nd++] = (char) (c - '0');
+    else if (c != '0')
+      dec->trunc = true;
+  }
+  if (!sawDot)
+    dec->dp = nd;
+  if (i < length)
+  {
+    ++i;
+    int sign = 1;
+    if (chars[i] == '+')
+      ++i;
+    else if (chars[i] == '-')
+    {
+      sign = -1;
+      ++i;
+    }
+    int exp = 0;
+    for (; i < length; ++i)
+      if (exp < EXPONENT_MAX)
+        exp = exp * 10 + (chars[i] - '0');
+    dec->dp += exp * sign;
+  }
+  decimal_trim(dec);
+}
+
+static inline void decimal_trim(Decimal *dec)
+{
+  while (dec->nd > 0 && !dec->d[dec->nd - 1])
+    --dec->nd;
+  if (!dec->nd)
+    dec->dp = 0;
+}
+
+static inline void decimal_left_shift(Decimal *dec, int k)
+{
+  // Multiply by 2^k, producing digits from the least significant one, then
+  // store them back most significant first.
+  char digits[DECIMAL_MAX_DIGITS + 20];
+  int n = 0;
+  uint64_t carry = 0;
+  for (int r = dec->nd - 1; r >= 0; --r)
+  {
+    carry += (uint64_t) dec->d[r] << k;
+    digits[n++] = (char) (carry % 10);
+    carry /= 10;
+  }
+  while (carry)
+  {
+    digits[n++] = (char) (carry % 10);
+    carry /= 10;
+  }
+  dec->dp += n - dec->nd;
+  int nd = n < DECIMAL_MAX_DIGITS ? n : DECIMAL_MAX_DIGITS;
+  for (int i = 0; i < n - nd; ++i)
+    if (digits[i])
+      dec->trunc = true;
+  for (int w = 0; w < nd; ++w)
+    dec->d[w] = digits[n - 1 - w];
+  dec->nd = nd;
+  decimal_trim(dec);
+}
+
+static inline void decimal_right_shift(Decimal *dec, int k)
+{
+  int r = 0;
+  int w = 0;
+  uint64_t n = 0;
+  // Pick up enough leading digits to cover the first shift.
+  for (; !(n >> k); ++r)
+  {
+    if (r >= dec->nd)
+    {
+      if (!n)
+      {
+        dec->nd = 0;
+        return;
+      }
+      while (!(n >> k))
+      {
+        n *= 10;
+        ++r;
+      }
+      break;
+    }
+    n = n * 10 + (uint64_t) dec->d[r];
+  }
+  dec->dp -= r - 1;
+  uint64_t mask = ((uint64_t) 1 << k) - 1;
+  for (; r < dec->nd; ++r)
+  {
+    dec->d[w++] = (char) (n >> k);
+    n &= mask;
+    n = n * 10 + (uint64_t) dec->d[r];
+  }
+  while (n)
+  {
+    char digit = (char) (n >> k);
+    n &= mask;
+    if (w < DECIMAL_MAX_DIGITS)
+      dec->d[w++] = digit;
+    else if (digit)
+      dec->trunc = true;
+    n *= 10;
+  }
+  dec->nd = w;
+  decimal_trim(dec);
+}
+
+static inline void decimal_shift(Decimal *dec, int k)
+{
+  if (!dec->nd) return;
+  for (; k > DECIMAL_MAX_SHIFT; k -= DECIMAL_MAX_SHIFT)
+    decimal_left_shift(dec, DECIMAL_MAX_SHIFT);
+  for (; k < -DECIMAL_MAX_SHIFT; k += DECIMAL_MAX_SHIFT)
+    decimal_right_shift(dec, DECIMAL_MAX_SHIFT);
+  if (k > 0)
+    decimal_left_shift(dec, k);
+  else if (k < 0)
+    decimal_right_shift(dec, -k);
+}
+
+static inline bool decimal_should_round_up(Decimal *dec, int nd)
+{
+  if (nd < 0 || nd >= dec->nd) return false;
+  // Exactly halfway rounds to even, unless digits were dropped.
+  if (dec->d[nd] == 5 && nd + 1 == dec->nd)
+    return dec->trunc || (nd > 0 && dec->d[nd - 1] % 2);
+  return dec->d[nd] >= 5;
+}
+
+static inline uint64_t decimal_rounded_integer(Decimal *dec)
+{
+  if (dec->dp > 20) return UINT64_MAX;
+  uint64_t n = 0;
+  int i = 0;
+  for (; i < dec->dp && i < dec->nd; ++i)
+    n = n * 10 + (uint64_t) dec->d[i];
+  for (; i < dec->dp; ++i)
+    n *= 10;
+  if (decimal_should_round_up(dec, dec->dp))
+    ++n;
+  return n;
+}
+
+static double decimal_to_double(Decimal *dec)
+{
+  const int numPow2 = (int) (sizeof(decimal_pow2) / sizeof(*decimal_pow2));
+  const int minExp = 1 - DOUBLE_EXPONENT_BIAS;
+  const uint64_t inf = 0x7FF0000000000000ULL;
+  if (!dec->nd || dec->dp < -330) return 0;
+  if (dec->dp > 310) return from_bits(inf);
+  // Scale by powers of two into [0.5, 1).
+  int exp = 0;
+  while (dec->dp > 0)
+  {
+    int n = dec->dp >= numPow2 ? 27 : decimal_pow2[dec->dp];
+    decimal_shift(dec, -n);
+    exp += n;
+  }
+  while (dec->dp < 0 || (!dec->dp && dec->d[0] < 5))
+  {
+    int n = -dec->dp >= numPow2 ? 27 : decimal_pow2[-dec->dp];
+    decimal_shift(dec, n);
+    exp -= n;
+  }
+  // Doubles are normalized to [1, 2).
+  --exp;
+  if (exp < minExp)
+  {
+    decimal_shift(dec, -(minExp - exp));
+    exp = minExp;
+  }
+  if (exp + DOUBLE_EXPONENT_BIAS >= 0x7FF) return from_bits(inf);
+  decimal_shift(dec, 1 + DOUBLE_MANTISSA_BITS);
+  uint64_t mantissa = decimal_rounded_integer(dec);
+  // Rounding might have carried into a new bit.
+  if (mantissa == (uint64_t) 2 << DOUBLE_MANTISSA_BITS)
+  {
+    mantissa >>= 1;
+    ++exp;
+    if (exp + DOUBLE_EXPONENT_BIAS >= 0x7FF) return from_bits(inf);
+  }
+  uint64_t biased = (uint64_t) (exp + DOUBLE_EXPONENT_BIAS);
+  // Subnormal.
+  if (!(mantissa & ((uint64_t) 1 << DOUBLE_MANTISSA_BITS)))
+    biased = 0;
+  uint64_t bits = (biased << DOUBLE_MANTISSA_BITS)
+    | (mantissa & (((uint64_t) 1 << DOUBLE_MANTISSA_BITS) - 1));
+  return from_bits(bits);
+}
+
+double number_from_chars(const char *chars, int length)
+{
+  double result;
+  if (parse_integer(chars, length, &result))
+    return result;
+  Decomposed dec = decompose(chars, length);
+  if (clinger(&dec, &result))
+    return result;
+  if (eisel_lemire(dec.mantissa, dec.exp10, &result))
+  {
+    if (!dec.trunc)
+      return result;
+    // With dropped digits the value lies between the mantissa and the next
+    // one up; when both round the same way, so does the exact value.
+    double upper;
+    if (eisel_lemire(dec.mantissa + 1, dec.exp10, &upper) && result == upper)
+      return result;
+  }
+  Decimal slow;
+  decimal_init(&slow, chars, length);
+  return decimal_to_double(&slow);
+}
@@ -0,0 +1,19 @@
+//
+// number.h
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef NUMBER_H
+#define NUMBER_H
+
+// Converts a NUMBER token to the nearest double, rounding ties to even.
+// Does not allocate and does not depend on the locale. Literals too large
+// for a double yield infinity.
+double number_from_chars(const char *chars, int length);
+
+#endif // NUMBER_H
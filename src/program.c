@@ -0,0 +1,38 @@
+//
+// program.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include "glim.h"
+#include <string.h>
+#include "compiler.h"
+
+void glim_program_init(GlimProgram *prog, const char *source, Error *err)
+{
+  // Nothing points into the source once compilation returns; the copy is
+  // kept for the bytecode and debug info a later backend will attach.
+  size_t size = strlen(source) + 1;
+  prog->source = memory_alloc(size, err);
+  if (!ok(err)) return;
+  memcpy(prog->source, source, size);
+  diagnostics_init(&prog->diag, err);
+  if (!ok(err)) goto fail;
+  compile(prog->source, err, &prog->diag);
+  if (!ok(err)) goto fail_diag;
+  return;
+fail_diag:
+  diagnostics_deinit(&prog->diag);
+fail:
+  memory_free(prog->source);
+}
+
+void glim_program_deinit(GlimProgram *prog)
+{
+  diagnostics_deinit(&prog->diag);
+  memory_free(prog->source);
+}
@@ -11,7 +11,9 @@
 #ifndef SLICE_H
 #define SLICE_H
 
+#include <string.h>
 #include "memory.h"
+#include "stats.h"
 
 #define SLICE_MIN_CAPACITY 8
 
@@ -58,6 +60,29 @@
     size_t size = sizeof(*(s)->slots) * _cap; \
     void *slots = memory_realloc((s)->slots, size, (err)); \
     if (!ok(err)) break; \
+    stats_record_slice_growth(size); \
+    (s)->cap = _cap; \
+    (s)->slots = slots; \
+  } while (0)
+
+#define slice_reserve(s, c, err) \
+  do { \
+    if ((c) <= (s)->cap) break; \
+    size_t size = sizeof(*(s)->slots) * (c); \
+    void *slots = memory_realloc((s)->slots, size, (err)); \
+    if (!ok(err)) break; \
+    stats_record_slice_growth(size); \
+    (s)->cap = (c); \
+    (s)->slots = slots; \
+  } while (0)
+
+#define slice_shrink(s, err) \
+  do { \
+    size_t _cap = (s)->len > SLICE_MIN_CAPACITY ? (s)->len : SLICE_MIN_CAPACITY; \
+    if (_cap >= (s)->cap) break; \
+    size_t size = sizeof(*(s)->slots) * _cap; \
+    void *slots = memory_realloc((s)->slots, size, (err)); \
+    if (!ok(err)) break; \
     (s)->cap = _cap; \
     (s)->slots = slots; \
   } while (0)
@@ -74,16 +99,35 @@
     ++(s)->len; \
   } while (0)
 
+#define slice_append_n(s, v, n, err) \
+  do { \
+    slice_ensure_capacity((s), (s)->len + (n), err); \
+    if (!ok(err)) break; \
+    memcpy(&(s)->slots[(s)->len], (v), sizeof(*(s)->slots) * (n)); \
+    (s)->len += (n); \
+  } while (0)
+
 #define slice_set(s, i, v) \
   do { \
     (s)->slots[(i)] = (v); \
   } while (0)
 
+// The index is evaluated before len changes, so it may refer to len.
 #define slice_remove_at(s, i) \
   do { \
+    size_t _i = (i); \
+    --(s)->len; \
+    memmove(&(s)->slots[_i], &(s)->slots[_i + 1], \
+      sizeof(*(s)->slots) * ((s)->len - _i)); \
+  } while (0)
+
+// Removes in O(1) by moving the last element into the hole; does not
+// preserve order.
+#define slice_swap_remove_at(s, i) \
+  do { \
+    size_t _i = (i); \
     --(s)->len; \
-    for (size_t j = (i); j < (s)->len; ++j) \
-      (s)->slots[j] = (s)->slots[j + 1]; \
+    (s)->slots[_i] = (s)->slots[(s)->len]; \
   } while (0)
 
 #define slice_clear(s) \
@@ -91,4 +135,82 @@
     (s)->len = 0; \
   } while (0)
 
+// A slice whose first n elements live inline, so short ones never touch the
+// heap. Elements move to the heap on the first growth past n. The inline
+// storage is addressed through inline_slice_slots rather than a pointer to
+// itself, so the struct can be copied like any other value.
+#define InlineSlice(T, n) \
+  struct { \
+    size_t cap; \
+    size_t len; \
+    T      *heap; \
+    T      buf[(n)]; \
+  }
+
+#define inline_slice_init(s) \
+  do { \
+    (s)->cap = sizeof((s)->buf) / sizeof(*(s)->buf); \
+    (s)->len = 0; \
+    (s)->heap = NULL; \
+  } while (0)
+
+#define inline_slice_deinit(s) \
+  do { \
+    memory_free((s)->heap); \
+  } while (0)
+
+#define inline_slice_slots(s) ((s)->heap ? (s)->heap : (s)->buf)
+
+#define inline_slice_ensure_capacity(s, c, err) \
+  do { \
+    if ((c) <= (s)->cap) break; \
+    size_t _cap = (s)->cap << 1; \
+    while (_cap < (c)) _cap <<= 1; \
+    size_t size = sizeof(*(s)->buf) * _cap; \
+    void *heap = memory_realloc((s)->heap, size, (err)); \
+    if (!ok(err)) break; \
+    if (!(s)->heap) \
+      memcpy(heap, (s)->buf, sizeof(*(s)->buf) * (s)->len); \
+    stats_record_slice_growth(size); \
+    (s)->cap = _cap; \
+    (s)->heap = heap; \
+  } while (0)
+
+#define inline_slice_is_empty(s) (!(s)->len)
+
+#define inline_slice_get(s, i) (inline_slice_slots(s)[(i)])
+
+#define inline_slice_append(s, v, err) \
+  do { \
+    inline_slice_ensure_capacity((s), (s)->len + 1, err); \
+    if (!ok(err)) break; \
+    inline_slice_slots(s)[(s)->len] = (v); \
+    ++(s)->len; \
+  } while (0)
+
+#define inline_slice_append_n(s, v, n, err) \
+  do { \
+    inline_slice_ensure_capacity((s), (s)->len + (n), err); \
+    if (!ok(err)) break; \
+    memcpy(&inline_slice_slots(s)[(s)->len], (v), sizeof(*(s)->buf) * (n)); \
+    (s)->len += (n); \
+  } while (0)
+
+#define inline_slice_set(s, i, v) \
+  do { \
+    inline_slice_slots(s)[(i)] = (v); \
+  } while (0)
+
+#define inline_slice_swap_remove_at(s, i) \
+  do { \
+    size_t _i = (i); \
+    --(s)->len; \
+    inline_slice_slots(s)[_i] = inline_slice_slots(s)[(s)->len]; \
+  } while (0)
+
+#define inline_slice_clear(s) \
+  do { \
+    (s)->len = 0; \
+  } while (0)
+
 #endif // SLICE_H
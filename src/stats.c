@@ -0,0 +1,74 @@
+//
+// stats.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef _WIN32
+  #define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#endif
+
+THREAD_LOCAL Stats *stats_active = NULL;
+
+void glim_stats_begin(Stats *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  stats_active = stats;
+}
+
+void glim_stats_end(void)
+{
+  stats_active = NULL;
+}
+
+double stats_clock(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double) count.QuadPart / (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#endif
+}
+
+void stats_record_slice_growth(size_t size)
+{
+  Stats *stats = stats_active;
+  if (!stats) return;
+  ++stats->numSliceGrowths;
+  stats->sliceGrowthBytes += size;
+}
+
+void glim_stats_print(Stats *stats)
+{
+  // Lexing is only timed on its own when the input was pre-lexed; otherwise
+  // it is part of the compile time.
+  if (stats->lexSeconds > 0)
+    printf("lex time:      %.6f s\n", stats->lexSeconds);
+  printf("compile time:  %.6f s\n", stats->compileSeconds);
+  printf("tokens:        %ld\n", stats->numTokens);
+  printf("nodes:         %ld\n", stats->numNodes);
+  printf("allocs:        %ld (%zu bytes)\n", stats->numAllocs, stats->allocBytes);
+  // Slice growths go through memory_realloc, so they are a subset of reallocs.
+  printf("reallocs:      %ld (%zu bytes)\n", stats->numReallocs, stats->reallocBytes);
+  printf("  of which slice growths: %ld (%zu bytes)\n", stats->numSliceGrowths,
+    stats->sliceGrowthBytes);
+}
@@ -0,0 +1,37 @@
+//
+// stats.h
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "glim.h"
+
+#ifdef _MSC_VER
+  #define THREAD_LOCAL __declspec(thread)
+#else
+  #define THREAD_LOCAL _Thread_local
+#endif
+
+typedef GlimStats Stats;
+
+#define stats_count(f) \
+  do { \
+    if (stats_active) ++stats_active->f; \
+  } while (0)
+
+// Counters are only collected between glim_stats_begin and glim_stats_end,
+// and only on the calling thread, so compiling with stats disabled costs one
+// check.
+extern THREAD_LOCAL Stats *stats_active;
+
+double stats_clock(void);
+void stats_record_slice_growth(size_t size);
+
+#endif // STATS_H
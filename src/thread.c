@@ -0,0 +1,108 @@
+//
+// thread.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include "thread.h"
+
+#ifndef _WIN32
+  #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static DWORD WINAPI thread_main(LPVOID param);
+#else
+static void *thread_main(void *param);
+#endif
+
+#ifdef _WIN32
+static DWORD WINAPI thread_main(LPVOID param)
+{
+  Thread *thrd = param;
+  thrd->fn(thrd->arg);
+  return 0;
+}
+#else
+static void *thread_main(void *param)
+{
+  Thread *thrd = param;
+  thrd->fn(thrd->arg);
+  return NULL;
+}
+#endif
+
+void thread_start(Thread *thrd, ThreadFn fn, void *arg, Error *err)
+{
+  thrd->fn = fn;
+  thrd->arg = arg;
+#ifdef _WIN32
+  thrd->handle = CreateThread(NULL, 0, thread_main, thrd, 0, NULL);
+  if (!thrd->handle) error_set(err, "cannot start thread");
+#else
+  if (pthread_create(&thrd->handle, NULL, thread_main, thrd))
+    error_set(err, "cannot start thread");
+#endif
+}
+
+void thread_join(Thread *thrd)
+{
+#ifdef _WIN32
+  WaitForSingleObject(thrd->handle, INFINITE);
+  CloseHandle(thrd->handle);
+#else
+  pthread_join(thrd->handle, NULL);
+#endif
+}
+
+int thread_hardware_concurrency(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int n = (int) info.dwNumberOfProcessors;
+#else
+  int n = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return n > 0 ? n : 1;
+}
+
+void mutex_init(Mutex *mtx)
+{
+#ifdef _WIN32
+  InitializeCriticalSection(&mtx->handle);
+#else
+  pthread_mutex_init(&mtx->handle, NULL);
+#endif
+}
+
+void mutex_deinit(Mutex *mtx)
+{
+#ifdef _WIN32
+  DeleteCriticalSection(&mtx->handle);
+#else
+  pthread_mutex_destroy(&mtx->handle);
+#endif
+}
+
+void mutex_lock(Mutex *mtx)
+{
+#ifdef _WIN32
+  EnterCriticalSection(&mtx->handle);
+#else
+  pthread_mutex_lock(&mtx->handle);
+#endif
+}
+
+void mutex_unlock(Mutex *mtx)
+{
+#ifdef _WIN32
+  LeaveCriticalSection(&mtx->handle);
+#else
+  pthread_mutex_unlock(&mtx->handle);
+#endif
+}
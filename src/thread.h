@@ -0,0 +1,52 @@
+//
+// thread.h
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#include "error.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
+
+typedef void (*ThreadFn)(void *arg);
+
+typedef struct
+{
+  ThreadFn fn;
+  void     *arg;
+#ifdef _WIN32
+  HANDLE   handle;
+#else
+  pthread_t handle;
+#endif
+} Thread;
+
+typedef struct
+{
+#ifdef _WIN32
+  CRITICAL_SECTION handle;
+#else
+  pthread_mutex_t handle;
+#endif
+} Mutex;
+
+void thread_start(Thread *thrd, ThreadFn fn, void *arg, Error *err);
+void thread_join(Thread *thrd);
+int thread_hardware_concurrency(void);
+void mutex_init(Mutex *mtx);
+void mutex_deinit(Mutex *mtx);
+void mutex_lock(Mutex *mtx);
+void mutex_unlock(Mutex *mtx);
+
+#endif // THREAD_H
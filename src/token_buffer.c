@@ -0,0 +1,98 @@
+//
+// token_buffer.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include "token_buffer.h"
+#include <string.h>
+
+#define TOKEN_BUFFER_BYTES_PER_TOKEN (4)
+
+static inline void append_token(TokenBuffer *buf, Token *token, Error *err);
+
+static inline void append_token(TokenBuffer *buf, Token *token, Error *err)
+{
+  size_t offset = token->chars - buf->source;
+  slice_append(&buf->kinds, (uint8_t) token->kind, err);
+  if (!ok(err)) return;
+  slice_append(&buf->offsets, (uint32_t) offset, err);
+  if (!ok(err)) return;
+  slice_append(&buf->lengths, (uint32_t) token->length, err);
+}
+
+void token_buffer_init(TokenBuffer *buf, char *source, Error *err)
+{
+  size_t length = strlen(source);
+  if (length >= UINT32_MAX)
+  {
+    error_set(err, "source too large");
+    return;
+  }
+  buf->source = source;
+  error_init(&buf->err);
+  slice_init(&buf->kinds, err);
+  if (!ok(err)) return;
+  slice_init(&buf->offsets, err);
+  if (!ok(err)) goto fail_kinds;
+  slice_init(&buf->lengths, err);
+  if (!ok(err)) goto fail_offsets;
+  // Reserve exactly for the usual token density, rather than rounding a
+  // large estimate up to the next power of two.
+  size_t cap = length / TOKEN_BUFFER_BYTES_PER_TOKEN + 1;
+  slice_reserve(&buf->kinds, cap, err);
+  if (!ok(err)) goto fail_lengths;
+  slice_reserve(&buf->offsets, cap, err);
+  if (!ok(err)) goto fail_lengths;
+  slice_reserve(&buf->lengths, cap, err);
+  if (!ok(err)) goto fail_lengths;
+  Lexer lex;
+  lexer_init(&lex, source, &buf->err);
+  while (ok(&buf->err))
+  {
+    append_token(buf, &lex.token, err);
+    if (!ok(err)) goto fail_lengths;
+    if (lex.token.kind == TOKEN_KIND_EOF) break;
+    lexer_next(&lex);
+  }
+  return;
+fail_lengths:
+  slice_deinit(&buf->lengths);
+fail_offsets:
+  slice_deinit(&buf->offsets);
+fail_kinds:
+  slice_deinit(&buf->kinds);
+}
+
+void token_buffer_deinit(TokenBuffer *buf)
+{
+  slice_deinit(&buf->kinds);
+  slice_deinit(&buf->offsets);
+  slice_deinit(&buf->lengths);
+}
+
+void token_buffer_locate(TokenBuffer *buf, size_t index, int *ln, int *col)
+{
+  // String tokens start after the quote, but are reported at the quote.
+  uint32_t start = slice_get(&buf->offsets, index);
+  if (token_buffer_kind(buf, index) == TOKEN_KIND_STRING)
+    --start;
+  int _ln = 1;
+  int _col = 1;
+  for (uint32_t i = 0; i < start; ++i)
+  {
+    if (buf->source[i] == '\n')
+    {
+      ++_ln;
+      _col = 1;
+      continue;
+    }
+    ++_col;
+  }
+  *ln = _ln;
+  *col = _col;
+}
@@ -0,0 +1,40 @@
+//
+// token_buffer.h
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <stdint.h>
+#include "lexer.h"
+#include "slice.h"
+
+#define token_buffer_len(b)       ((b)->kinds.len)
+#define token_buffer_kind(b, i)   ((TokenKind) slice_get(&(b)->kinds, (i)))
+#define token_buffer_length(b, i) ((int) slice_get(&(b)->lengths, (i)))
+#define token_buffer_chars(b, i)  (&(b)->source[slice_get(&(b)->offsets, (i))])
+
+// The whole input lexed up front, one array per field. Line and column are
+// not stored; token_buffer_locate recovers them from the offset when a
+// diagnostic needs them. A lexing error stops the buffer short and is kept
+// in err, so it surfaces only once the parser reaches that point.
+typedef struct
+{
+  char             *source;
+  Slice(uint8_t)   kinds;
+  Slice(uint32_t)  offsets;
+  Slice(uint32_t)  lengths;
+  Error            err;
+} TokenBuffer;
+
+void token_buffer_init(TokenBuffer *buf, char *source, Error *err);
+void token_buffer_deinit(TokenBuffer *buf);
+void token_buffer_locate(TokenBuffer *buf, size_t index, int *ln, int *col);
+
+#endif // TOKEN_BUFFER_H
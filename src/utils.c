@@ -9,7 +9,9 @@
 //
 
 #include "utils.h"
+#include <stdio.h>
 #include <string.h>
+#include "memory.h"
 
 void copy_cstring(char *dest, const char *src, int n)
 {
@@ -19,3 +21,37 @@ void copy_cstring(char *dest, const char *src, int n)
   strncpy(dest, src, n);
 #endif
 }
+
+char *read_file(const char *path, Error *err)
+{
+  FILE *fp = NULL;
+#ifdef _WIN32
+  fopen_s(&fp, path, "rb");
+#else
+  fp = fopen(path, "rb");
+#endif
+  if (!fp)
+  {
+    error_set(err, "cannot open file '%s'", path);
+    return NULL;
+  }
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  if (size < 0)
+  {
+    fclose(fp);
+    error_set(err, "cannot read file '%s'", path);
+    return NULL;
+  }
+  char *source = memory_alloc(size + 1, err);
+  if (!ok(err))
+  {
+    fclose(fp);
+    return NULL;
+  }
+  size_t n = fread(source, 1, size, fp);
+  fclose(fp);
+  source[n] = '\0';
+  return source;
+}
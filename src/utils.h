@@ -11,6 +11,9 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include "error.h"
+
 void copy_cstring(char *dest, const char *src, int n);
+char *read_file(const char *path, Error *err);
 
 #endif // UTILS_H
@@ -1,3 +1,5 @@
 @echo off
 
 build\Debug\glim
+cd build
+ctest -C Debug --output-on-failure
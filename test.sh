@@ -1,3 +1,4 @@
 #!/usr/bin/env bash
 
 build/glim
+cd build && ctest --output-on-failure
@@ -0,0 +1,104 @@
+//
+// depth_test.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+
+#define TOO_DEEP "expression nested too deeply"
+
+// Each source is open repeated count times, then middle, then close
+// repeated count times. Against COMPILER_MAX_DEPTH (512), each parenthesis
+// or array literal costs two levels and each ternary arm or unary operator
+// one. The let run would overflow the stack if statements still recursed.
+typedef struct
+{
+  const char *name;
+  const char *open;
+  int        count;
+  const char *middle;
+  const char *close;
+  bool       ok;
+} Case;
+
+static const Case cases[] = {
+  { "255 parentheses",   "(",             255,    "1", ")", true  },
+  { "256 parentheses",   "(",             256,    "1", ")", false },
+  { "510 ternary arms",  "x == 0 ? 0 : ", 510,    "0", "",  true  },
+  { "511 ternary arms",  "x == 0 ? 0 : ", 511,    "0", "",  false },
+  { "510 unary minuses", "-",             510,    "1", "",  true  },
+  { "511 unary minuses", "-",             511,    "1", "",  false },
+  { "255 nested arrays", "[",             255,    "1", "]", true  },
+  { "256 nested arrays", "[",             256,    "1", "]", false },
+  { "long let run",      "let x = 1;\n",  200000, "x", "",  true  }
+};
+
+static char *make_source(const Case *c);
+
+static char *make_source(const Case *c)
+{
+  size_t openLength = strlen(c->open);
+  size_t middleLength = strlen(c->middle);
+  size_t closeLength = strlen(c->close);
+  size_t length = (openLength + closeLength) * c->count + middleLength;
+  char *source = malloc(length + 1);
+  if (!source) return NULL;
+  char *dest = source;
+  for (int i = 0; i < c->count; ++i, dest += openLength)
+    memcpy(dest, c->open, openLength);
+  memcpy(dest, c->middle, middleLength);
+  dest += middleLength;
+  for (int i = 0; i < c->count; ++i, dest += closeLength)
+    memcpy(dest, c->close, closeLength);
+  *dest = '\0';
+  return source;
+}
+
+int main(void)
+{
+  int numCases = (int) (sizeof(cases) / sizeof(*cases));
+  int numFailed = 0;
+  for (int i = 0; i < numCases; ++i)
+  {
+    const Case *c = &cases[i];
+    char *source = make_source(c);
+    if (!source)
+    {
+      printf("FAIL: %s: out of memory\n", c->name);
+      ++numFailed;
+      continue;
+    }
+    Error err;
+    error_init(&err);
+    Diagnostics diag;
+    diagnostics_init(&diag, &err);
+    if (!ok(&err))
+    {
+      printf("FAIL: %s: %s\n", c->name, err.str);
+      ++numFailed;
+      free(source);
+      continue;
+    }
+    compile(source, &err, &diag);
+    bool passed = c->ok ? ok(&err)
+      : !ok(&err) && !strncmp(err.str, TOO_DEEP, strlen(TOO_DEEP));
+    if (!passed)
+    {
+      printf("FAIL: %s: expected %s, got '%s'\n", c->name, c->ok ? "ok" : TOO_DEEP,
+        ok(&err) ? "ok" : err.str);
+      ++numFailed;
+    }
+    diagnostics_deinit(&diag);
+    free(source);
+  }
+  printf("%d/%d passed\n", numCases - numFailed, numCases);
+  return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
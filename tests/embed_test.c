@@ -0,0 +1,60 @@
+//
+// embed_test.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+// Built against libglim and include/ only, as an embedder would be, and
+// kept within the common subset of C and C++ so embed_test.cpp can compile
+// it again as C++.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glim.h>
+
+#if defined(ok) || defined(error_init) || defined(Slice) || defined(THREAD_LOCAL) \
+  || defined(stats_count) || defined(ERROR_MAX_LENGTH) || defined(MESSAGE_KIND_ERROR)
+  #error "glim.h leaks internal macros"
+#endif
+
+typedef struct
+{
+  const char *name;
+  const char *source;
+  bool       ok;
+} Case;
+
+static const Case cases[] = {
+  { "valid",         "let x = 1; x + 1", true  },
+  { "syntax error",  "let = ;",          false },
+  { "empty",         "",                 true  }
+};
+
+int main(void)
+{
+  int numCases = (int) (sizeof(cases) / sizeof(*cases));
+  int numFailed = 0;
+  for (int i = 0; i < numCases; ++i)
+  {
+    const Case *c = &cases[i];
+    GlimError err;
+    err.ok = true;
+    GlimStats stats;
+    glim_stats_begin(&stats);
+    GlimProgram prog;
+    glim_program_init(&prog, c->source, &err);
+    glim_stats_end();
+    if (err.ok)
+      glim_program_deinit(&prog);
+    if (err.ok == c->ok) continue;
+    printf("FAIL: %s: expected %s, got %s\n", c->name, c->ok ? "ok" : "an error",
+      err.ok ? "ok" : err.str);
+    ++numFailed;
+  }
+  printf("%d/%d passed\n", numCases - numFailed, numCases);
+  return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
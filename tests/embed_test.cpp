@@ -0,0 +1,13 @@
+//
+// embed_test.cpp
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+// Links only if glim.h gives its functions C linkage.
+
+#include "embed_test.c"
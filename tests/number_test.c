@@ -0,0 +1,84 @@
+//
+// number_test.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "number.h"
+
+#define LITERAL_MAX_LENGTH (1023)
+
+// Each literal is prefix, then zeros repeated '0's, then suffix, so that
+// mantissas longer than the slow path's digit buffer stay readable here.
+// Expected values are the bit patterns of the correctly rounded double.
+typedef struct
+{
+  const char *name;
+  const char *prefix;
+  int        zeros;
+  const char *suffix;
+  uint64_t   expected;
+} Case;
+
+static const Case cases[] = {
+  { "integer", "123456789", 0, "", 0x419D6F3454000000ULL },
+  { "clinger", "0.1", 0, "", 0x3FB999999999999AULL },
+  { "eisel-lemire", "7.038531e-26", 0, "", 0x3AB5C87FB0000000ULL },
+  { "long mantissa", "123456789012345678901234567890", 0, "", 0x45F8EE90FF6C373EULL },
+  { "tie to even down", "9007199254740993", 0, "", 0x4340000000000000ULL },
+  { "tie to even up", "9007199254740995", 0, "", 0x4340000000000002ULL },
+  { "tie below one ulp", "1.00000000000000011102230246251565404236316680908203125", 0, "",
+    0x3FF0000000000000ULL },
+  { "tie above one ulp", "1.00000000000000033306690738754696212708950042724609375", 0, "",
+    0x3FF0000000000002ULL },
+  { "just past tie", "1.00000000000000011102230246251565404236316680908203125", 0, "1",
+    0x3FF0000000000001ULL },
+  { "tie broken past 800 digits", "9007199254740993.", 900, "1", 0x4340000000000001ULL },
+  { "smallest normal", "2.2250738585072014e-308", 0, "", 0x0010000000000000ULL },
+  { "largest subnormal", "2.2250738585072009e-308", 0, "", 0x000FFFFFFFFFFFFFULL },
+  { "smallest subnormal", "4.9406564584124654e-324", 0, "", 0x0000000000000001ULL },
+  { "half smallest subnormal", "2.4703282292062327e-324", 0, "", 0x0000000000000000ULL },
+  { "over half smallest subnormal", "2.4703282292062328e-324", 0, "", 0x0000000000000001ULL },
+  { "underflow", "1e-400", 0, "", 0x0000000000000000ULL },
+  { "largest double", "1.7976931348623157e308", 0, "", 0x7FEFFFFFFFFFFFFFULL },
+  { "rounds to largest double", "1.7976931348623158e308", 0, "", 0x7FEFFFFFFFFFFFFFULL },
+  { "overflow", "1.7976931348623159e308", 0, "", 0x7FF0000000000000ULL },
+  { "exponent overflow", "1e309", 0, "", 0x7FF0000000000000ULL },
+  { "900 integer digits", "1", 900, "e-895", 0x40F86A0000000000ULL },
+  { "820 integer digits overflow", "1", 820, "e-500", 0x7FF0000000000000ULL },
+  { "820 integer digits", "1", 820, "e-800", 0x4415AF1D78B58C40ULL },
+  { "900 fraction digits", "0.", 900, "1e905", 0x40C3880000000000ULL }
+};
+
+int main(void)
+{
+  int numCases = (int) (sizeof(cases) / sizeof(*cases));
+  int numFailed = 0;
+  char chars[LITERAL_MAX_LENGTH + 1];
+  for (int i = 0; i < numCases; ++i)
+  {
+    const Case *c = &cases[i];
+    int length = snprintf(chars, sizeof(chars), "%s%0*d%s", c->prefix, c->zeros, 0,
+      c->suffix);
+    // "%0*d" prints a single zero when asked for none.
+    if (!c->zeros)
+      length = snprintf(chars, sizeof(chars), "%s%s", c->prefix, c->suffix);
+    double result = number_from_chars(chars, length);
+    uint64_t bits;
+    memcpy(&bits, &result, sizeof(bits));
+    if (bits == c->expected) continue;
+    printf("FAIL: %s: expected 0x%016llX, got 0x%016llX\n", c->name,
+      (unsigned long long) c->expected, (unsigned long long) bits);
+    ++numFailed;
+  }
+  printf("%d/%d passed\n", numCases - numFailed, numCases);
+  return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+//
+// prelex_test.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+
+// Every source is compiled with tokens lexed on demand and pre-lexed into a
+// token buffer; both must report the same error and diagnostics.
+typedef struct
+{
+  const char *name;
+  const char *source;
+} Case;
+
+typedef struct
+{
+  Error       err;
+  Diagnostics diag;
+} Result;
+
+static const Case cases[] = {
+  { "empty",               "" },
+  { "lets only",           "let a = 1; let b = \"two\"; let c = [a, b];" },
+  { "lambdas and calls",   "let fib = n => n <= 1 ? n : fib(n - 1) + fib(n - 2);\nfib(10)" },
+  { "pipeline",            "let inc = x => x + 1;\n0 |> inc |> inc" },
+  { "unexpected token",    "let x = 1;\nlet y = ;" },
+  { "unexpected string",   "let x = 1;\n  x \"q\";" },
+  { "unexpected eof",      "let x = [1, 2" },
+  { "unexpected char",     "let x = 1;\nx # 2" },
+  { "unterminated string", "let s = \"abc" },
+  { "number out of range", "let big = 1e400;\nlet small = 2;\n  3e999" },
+  { "missing name",        "let = 1;" },
+  { "bad lambda params",   "a, 1 => a" }
+};
+
+static void compile_source(char *source, bool prelex, Result *res);
+static bool same_result(Result *res1, Result *res2);
+
+static void compile_source(char *source, bool prelex, Result *res)
+{
+  memset(res, 0, sizeof(*res));
+  error_init(&res->err);
+  diagnostics_init(&res->diag, &res->err);
+  if (!ok(&res->err)) return;
+  if (prelex)
+    compile_buffered(source, &res->err, &res->diag);
+  else
+    compile(source, &res->err, &res->diag);
+}
+
+static bool same_result(Result *res1, Result *res2)
+{
+  if (ok(&res1->err) != ok(&res2->err)) return false;
+  if (!ok(&res1->err) && strcmp(res1->err.str, res2->err.str)) return false;
+  if (res1->diag.messages.len != res2->diag.messages.len) return false;
+  for (size_t i = 0; i < res1->diag.messages.len; ++i)
+  {
+    Message *msg1 = &slice_get(&res1->diag.messages, i);
+    Message *msg2 = &slice_get(&res2->diag.messages, i);
+    if (msg1->kind != msg2->kind || strcmp(msg1->str, msg2->str))
+      return false;
+  }
+  return true;
+}
+
+int main(void)
+{
+  int numCases = (int) (sizeof(cases) / sizeof(*cases));
+  int numFailed = 0;
+  for (int i = 0; i < numCases; ++i)
+  {
+    const Case *c = &cases[i];
+    // The compiler takes a mutable source, so compile a copy.
+    size_t size = strlen(c->source) + 1;
+    char *source = malloc(size);
+    if (!source)
+    {
+      printf("FAIL: %s: out of memory\n", c->name);
+      ++numFailed;
+      continue;
+    }
+    memcpy(source, c->source, size);
+    Result expected;
+    Result result;
+    compile_source(source, false, &expected);
+    compile_source(source, true, &result);
+    if (!same_result(&expected, &result))
+    {
+      printf("FAIL: %s: expected '%s', got '%s'\n", c->name,
+        ok(&expected.err) ? "ok" : expected.err.str,
+        ok(&result.err) ? "ok" : result.err.str);
+      ++numFailed;
+    }
+    diagnostics_deinit(&expected.diag);
+    diagnostics_deinit(&result.diag);
+    free(source);
+  }
+  printf("%d/%d passed\n", numCases - numFailed, numCases);
+  return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+//
+// slice_test.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "slice.h"
+
+#define check(cond) \
+  do { \
+    ++numChecks; \
+    if (cond) break; \
+    printf("FAIL: %s:%d: %s\n", __func__, __LINE__, #cond); \
+    ++numFailed; \
+  } while (0)
+
+typedef Slice(int) IntSlice;
+typedef InlineSlice(int, 4) IntInlineSlice;
+
+static int numChecks = 0;
+static int numFailed = 0;
+
+static bool has_values(int *slots, size_t len, const int *values, size_t numValues);
+static void make_range(IntSlice *s, int n, Error *err);
+static void test_inline_migration(void);
+static void test_reserve_exact(void);
+static void test_shrink(void);
+static void test_swap_remove(void);
+static void test_remove_order(void);
+
+static bool has_values(int *slots, size_t len, const int *values, size_t numValues)
+{
+  if (len != numValues) return false;
+  for (size_t i = 0; i < len; ++i)
+    if (slots[i] != values[i])
+      return false;
+  return true;
+}
+
+static void make_range(IntSlice *s, int n, Error *err)
+{
+  slice_init(s, err);
+  for (int i = 0; ok(err) && i < n; ++i)
+    slice_append(s, i, err);
+}
+
+static void test_inline_migration(void)
+{
+  Error err;
+  error_init(&err);
+  IntInlineSlice s;
+  inline_slice_init(&s);
+  for (int i = 0; i < 4; ++i)
+    inline_slice_append(&s, i, &err);
+  check(ok(&err));
+  check(!s.heap);
+  check(s.cap == 4);
+  // Still inline, so a copy owns its own elements.
+  IntInlineSlice copy = s;
+  inline_slice_set(&copy, 0, 42);
+  check(inline_slice_get(&s, 0) == 0);
+  inline_slice_append(&s, 4, &err);
+  check(ok(&err));
+  check(s.heap != NULL);
+  check(s.cap == 8);
+  const int values[] = { 0, 1, 2, 3, 4 };
+  check(has_values(inline_slice_slots(&s), s.len, values, 5));
+  inline_slice_deinit(&s);
+}
+
+static void test_reserve_exact(void)
+{
+  Error err;
+  error_init(&err);
+  IntSlice s;
+  slice_init(&s, &err);
+  check(s.cap == SLICE_MIN_CAPACITY);
+  slice_reserve(&s, 100, &err);
+  check(ok(&err));
+  check(s.cap == 100);
+  slice_reserve(&s, 50, &err);
+  check(s.cap == 100);
+  slice_deinit(&s);
+}
+
+static void test_shrink(void)
+{
+  Error err;
+  error_init(&err);
+  IntSlice s;
+  make_range(&s, 20, &err);
+  check(ok(&err));
+  check(s.cap == 32);
+  s.len = 10;
+  slice_shrink(&s, &err);
+  check(ok(&err));
+  check(s.cap == 10);
+  const int values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  check(has_values(s.slots, s.len, values, 10));
+  s.len = 3;
+  slice_shrink(&s, &err);
+  check(s.cap == SLICE_MIN_CAPACITY);
+  check(has_values(s.slots, s.len, values, 3));
+  slice_deinit(&s);
+}
+
+static void test_swap_remove(void)
+{
+  Error err;
+  error_init(&err);
+  IntSlice s;
+  make_range(&s, 5, &err);
+  check(ok(&err));
+  slice_swap_remove_at(&s, 1);
+  const int middle[] = { 0, 4, 2, 3 };
+  check(has_values(s.slots, s.len, middle, 4));
+  slice_swap_remove_at(&s, s.len - 1);
+  const int last[] = { 0, 4, 2 };
+  check(has_values(s.slots, s.len, last, 3));
+  slice_deinit(&s);
+  IntInlineSlice t;
+  inline_slice_init(&t);
+  for (int i = 0; i < 4; ++i)
+    inline_slice_append(&t, i, &err);
+  inline_slice_swap_remove_at(&t, 1);
+  const int inlineMiddle[] = { 0, 3, 2 };
+  check(has_values(inline_slice_slots(&t), t.len, inlineMiddle, 3));
+  inline_slice_swap_remove_at(&t, t.len - 1);
+  check(has_values(inline_slice_slots(&t), t.len, inlineMiddle, 2));
+  inline_slice_deinit(&t);
+}
+
+static void test_remove_order(void)
+{
+  Error err;
+  error_init(&err);
+  IntSlice s;
+  make_range(&s, 6, &err);
+  check(ok(&err));
+  slice_remove_at(&s, 2);
+  const int middle[] = { 0, 1, 3, 4, 5 };
+  check(has_values(s.slots, s.len, middle, 5));
+  slice_remove_at(&s, 0);
+  const int first[] = { 1, 3, 4, 5 };
+  check(has_values(s.slots, s.len, first, 4));
+  slice_remove_at(&s, s.len - 1);
+  check(has_values(s.slots, s.len, first, 3));
+  slice_deinit(&s);
+}
+
+int main(void)
+{
+  test_inline_migration();
+  test_reserve_exact();
+  test_shrink();
+  test_swap_remove();
+  test_remove_order();
+  printf("%d/%d passed\n", numChecks - numFailed, numChecks);
+  return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
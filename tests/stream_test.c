@@ -0,0 +1,146 @@
+//
+// stream_test.c
+//
+// Copyright 2024 The Glim Authors and Contributors.
+//
+// This file is part of the Glim Project.
+// For detailed license information, please refer to the LICENSE file
+// located in the root directory of this project.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "lexer.h"
+
+// Each source is pad spaces, then head, then count copies of fill, then
+// tail, so tokens can be placed across or beyond the streaming window.
+typedef struct
+{
+  const char *name;
+  int        pad;
+  const char *head;
+  char       fill;
+  int        count;
+  const char *tail;
+} Case;
+
+typedef struct
+{
+  Error       err;
+  Diagnostics diag;
+} Result;
+
+static const Case cases[] = {
+  { "name across window",        LEXER_CHUNK_SIZE - 6,  "let ",      'a',  20,     " = 1;"     },
+  { "operator across window",    LEXER_CHUNK_SIZE - 3,  "1 == 1;",   ' ',  0,      ""          },
+  { "number across window",      LEXER_CHUNK_SIZE - 10, "let n = ", '7',  12,     ";"         },
+  { "string across window",      LEXER_CHUNK_SIZE - 12, "let s = \"", 'x', 30,     "\";"       },
+  { "string filling window",     0,                     "\"",        'x',  LEXER_CHUNK_SIZE - 2, "\";" },
+  { "string longer than window", 0,                     "let s = \"", 'x', 20000,  "\";"       },
+  { "string over many windows",  3,                     "let s = \"", 'x', 100000, "\";"       },
+  { "name longer than window",   0,                     "let ",      'n',  40000,  " = 1;"     },
+  { "unterminated string",       0,                     "let s = \"", 'x', 20000,  ""          },
+  { "error after long token",    0,                     "let s = \"", 'x', 20000,  "\"; let = 1;" },
+  { "lines across window",       0,                     "",          '\n', 20000,  "let = ;"   }
+};
+
+static char *make_source(const Case *c);
+static void compile_source(char *source, Result *res);
+static void compile_piped(char *source, Result *res);
+static bool same_result(Result *res1, Result *res2);
+
+static char *make_source(const Case *c)
+{
+  size_t headLength = strlen(c->head);
+  size_t tailLength = strlen(c->tail);
+  size_t length = c->pad + headLength + c->count + tailLength;
+  char *source = malloc(length + 1);
+  if (!source) return NULL;
+  char *dest = source;
+  memset(dest, ' ', c->pad);
+  dest += c->pad;
+  memcpy(dest, c->head, headLength);
+  dest += headLength;
+  memset(dest, c->fill, c->count);
+  dest += c->count;
+  memcpy(dest, c->tail, tailLength);
+  dest[tailLength] = '\0';
+  return source;
+}
+
+static void compile_source(char *source, Result *res)
+{
+  memset(res, 0, sizeof(*res));
+  error_init(&res->err);
+  diagnostics_init(&res->diag, &res->err);
+  if (!ok(&res->err)) return;
+  compile(source, &res->err, &res->diag);
+}
+
+static void compile_piped(char *source, Result *res)
+{
+  memset(res, 0, sizeof(*res));
+  error_init(&res->err);
+  diagnostics_init(&res->diag, &res->err);
+  if (!ok(&res->err)) return;
+  FILE *fp = tmpfile();
+  if (!fp)
+  {
+    error_set(&res->err, "cannot create temporary file");
+    return;
+  }
+  fputs(source, fp);
+  rewind(fp);
+  compile_stream(fp, &res->err, &res->diag);
+  fclose(fp);
+}
+
+static bool same_result(Result *res1, Result *res2)
+{
+  if (ok(&res1->err) != ok(&res2->err)) return false;
+  if (!ok(&res1->err) && strcmp(res1->err.str, res2->err.str)) return false;
+  if (res1->diag.messages.len != res2->diag.messages.len) return false;
+  for (size_t i = 0; i < res1->diag.messages.len; ++i)
+  {
+    Message *msg1 = &slice_get(&res1->diag.messages, i);
+    Message *msg2 = &slice_get(&res2->diag.messages, i);
+    if (msg1->kind != msg2->kind || strcmp(msg1->str, msg2->str))
+      return false;
+  }
+  return true;
+}
+
+int main(void)
+{
+  int numCases = (int) (sizeof(cases) / sizeof(*cases));
+  int numFailed = 0;
+  for (int i = 0; i < numCases; ++i)
+  {
+    const Case *c = &cases[i];
+    char *source = make_source(c);
+    if (!source)
+    {
+      printf("FAIL: %s: out of memory\n", c->name);
+      ++numFailed;
+      continue;
+    }
+    Result expected;
+    Result result;
+    compile_source(source, &expected);
+    compile_piped(source, &result);
+    if (!same_result(&expected, &result))
+    {
+      printf("FAIL: %s: expected '%s', got '%s'\n", c->name,
+        ok(&expected.err) ? "ok" : expected.err.str,
+        ok(&result.err) ? "ok" : result.err.str);
+      ++numFailed;
+    }
+    diagnostics_deinit(&expected.diag);
+    diagnostics_deinit(&result.diag);
+    free(source);
+  }
+  printf("%d/%d passed\n", numCases - numFailed, numCases);
+  return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}